@@ -17,6 +17,7 @@
 #include "MLX90640_I2C_Driver.h"
 #include "MLX90640_API.h"
 #include <math.h>
+#include <stddef.h>
 
 void ExtractVDDParameters(uint16_t *eeData, paramsMLX90640 *mlx90640);
 void ExtractPTATParameters(uint16_t *eeData, paramsMLX90640 *mlx90640);
@@ -35,27 +36,62 @@ int ExtractDeviatingPixels(uint16_t *eeData, paramsMLX90640 *mlx90640);
 int CheckAdjacentPixels(uint16_t pix1, uint16_t pix2);
 int CheckEEPROMValid(uint16_t *eeData);  
 float GetMedian(float *values, int n);
-int IsPixelBad(uint16_t pixel,paramsMLX90640 *params);
+int IsPixelBad(uint16_t pixel,const paramsMLX90640 *params);
+void AddBadPixel(uint16_t pixel, uint8_t mode, const paramsMLX90640 *params, calibrationMLX90640 *calibration);
+static inline float Root4(float x);
+#ifdef MLX90640_COMPACT_PARAMS
+void CompactArray(const int32_t *numerators, uint8_t scale, int16_t *values, uint8_t *valuesScale);
+#endif
 
   
+// Fourth root in single precision, the ESP32 FPU has no double support.
+// The approximation starts with a bit level guess of x^(-1/4), refines it with Newton
+// iterations to full float precision and returns x * x^(-3/4).
+static inline float Root4(float x)
+{
+#ifdef MLX90640_APPROXIMATE_ROOT
+    union { float f; uint32_t i; } bits;
+    float y;
+    float y2;
+    
+    bits.f = x;
+    bits.i = 0x4F5A827Au - (bits.i >> 2);
+    y = bits.f;
+    for(int i = 0; i < 3; i++)
+    {
+        y2 = y * y;
+        y = y * (1.25f - 0.25f * x * y2 * y2);
+    }
+    
+    return x * y * y * y;
+#else
+    return sqrtf(sqrtf(x));
+#endif
+}
+
+//------------------------------------------------------------------------------
+
 int MLX90640_DumpEE(uint8_t slaveAddr, uint16_t *eeData)
 {
      return MLX90640_I2CRead(slaveAddr, 0x2400, 832, eeData);
 }
 
-int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData)
+int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData, frameStatsMLX90640 *stats)
 {
     uint16_t dataReady = 1;
     uint16_t controlRegister1;
     uint16_t statusRegister;
     int error = 1;
     uint8_t cnt = 0;
-    uint8_t wait_cnt = 0;
+    uint16_t wait_cnt = 0;
     
     dataReady = 0;
+    if(stats != NULL)
+    {
+        stats->pollCount = 0;
+        stats->readCount = 0;
+    }
 
-    long start = millis(); 
-    
     while(dataReady == 0)
     {
         error = MLX90640_I2CRead(slaveAddr, 0x8000, 1, &statusRegister);
@@ -67,7 +103,10 @@ int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData)
         wait_cnt++;
     }       
 
-    long wait = millis(); 
+    if(stats != NULL)
+    {
+        stats->pollCount = wait_cnt;
+    }
         
     while(dataReady != 0 && cnt < 5)
     { 
@@ -92,7 +131,10 @@ int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData)
         cnt = cnt + 1;
     }
 
-    long rread = millis(); 
+    if(stats != NULL)
+    {
+        stats->readCount = cnt;
+    }
     
     if(cnt > 4)
     {
@@ -108,8 +150,6 @@ int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData)
     frameData[832] = controlRegister1;
     frameData[833] = statusRegister & 0x0001;
 
-    Serial.printf("Page: %d Wait: %d,%d Read: %d,%d", frameData[833], wait - start, wait_cnt, rread - wait, cnt);
-
     return frameData[833];    
 }
 
@@ -364,7 +404,7 @@ void MLX90640_CalculateTo(uint16_t *frameData, const paramsMLX90640 *params, flo
             }
             irData = irData * gain;
             
-            irData = irData - params->offset[pixelNumber]*(1 + params->kta[pixelNumber]*(ta - 25))*(1 + params->kv[pixelNumber]*(vdd - 3.3));
+            irData = irData - params->offset[pixelNumber]*(1 + MLX90640_GetKta(params, pixelNumber)*(ta - 25))*(1 + MLX90640_GetKv(params, pixelNumber)*(vdd - 3.3));
             if(mode !=  params->calibrationModeEE)
             {
               irData = irData + params->ilChessC[2] * (2 * ilPattern - 1) - params->ilChessC[1] * conversionPattern; 
@@ -374,7 +414,7 @@ void MLX90640_CalculateTo(uint16_t *frameData, const paramsMLX90640 *params, flo
     
             irData = irData - params->tgc * irDataCP[subPage];
             
-            alphaCompensated = (params->alpha[pixelNumber] - params->tgc * params->cpAlpha[subPage])*(1 + params->KsTa * (ta - 25));
+            alphaCompensated = (MLX90640_GetAlpha(params, pixelNumber) - params->tgc * params->cpAlpha[subPage])*(1 + params->KsTa * (ta - 25));
             
             Sx = pow((double)alphaCompensated, (double)3) * (irData + alphaCompensated * taTr);
             Sx = sqrt(sqrt(Sx)) * params->ksTo[1];
@@ -407,6 +447,278 @@ void MLX90640_CalculateTo(uint16_t *frameData, const paramsMLX90640 *params, flo
 
 //------------------------------------------------------------------------------
 
+int MLX90640_UpdateCalibration(uint16_t *frameData, const paramsMLX90640 *params, calibrationMLX90640 *calibration)
+{
+    float vdd;
+    float ta;
+    uint8_t mode;
+    int8_t ilPattern;
+    int8_t chessPattern;
+    int8_t pattern;
+    int8_t conversionPattern;
+    float ktaScale;
+    float kvScale;
+    float alphaScale;
+    uint16_t count[2];
+    uint16_t index;
+    
+    vdd = MLX90640_GetVdd(frameData, params);
+    ta = MLX90640_GetTa(frameData, params);
+    mode = (frameData[832] & 0x1000) >> 5;
+    
+    if(calibration->valid && calibration->mode == mode &&
+       fabsf(ta - calibration->ta) <= MLX90640_CALIBRATION_TA_DRIFT &&
+       fabsf(vdd - calibration->vdd) <= MLX90640_CALIBRATION_VDD_DRIFT)
+    {
+        return 0;
+    }
+    
+    ktaScale = ta - 25;
+    kvScale = vdd - 3.3f;
+    alphaScale = 1 + params->KsTa * (ta - 25);
+    
+    count[0] = 0;
+    count[1] = 0;
+    
+    for( int pixelNumber = 0; pixelNumber < 768; pixelNumber++)
+    {
+        ilPattern = pixelNumber / 32 - (pixelNumber / 64) * 2; 
+        chessPattern = ilPattern ^ (pixelNumber - (pixelNumber/2)*2); 
+        conversionPattern = ((pixelNumber + 2) / 4 - (pixelNumber + 3) / 4 + (pixelNumber + 1) / 4 - pixelNumber / 4) * (1 - 2 * ilPattern);
+        pattern = mode == 0 ? ilPattern : chessPattern;
+        index = count[pattern]++;
+        
+        calibration->pixels[pattern][index] = pixelNumber;
+        
+        calibration->offsetComp[pattern][index] = params->offset[pixelNumber] * (1 + MLX90640_GetKta(params, pixelNumber) * ktaScale) * (1 + MLX90640_GetKv(params, pixelNumber) * kvScale);
+        if(mode != params->calibrationModeEE)
+        {
+            calibration->offsetComp[pattern][index] -= params->ilChessC[2] * (2 * ilPattern - 1) - params->ilChessC[1] * conversionPattern;
+        }
+        
+        calibration->alphaComp[pattern][index] = (MLX90640_GetAlpha(params, pixelNumber) - params->tgc * params->cpAlpha[pattern]) * alphaScale;
+    }
+    
+    calibration->badPixelCount = 0;
+    for(int i = 0; i < 5; i++)
+    {
+        if(params->brokenPixels[i] < 768)
+        {
+            AddBadPixel(params->brokenPixels[i], mode, params, calibration);
+        }
+        if(params->outlierPixels[i] < 768)
+        {
+            AddBadPixel(params->outlierPixels[i], mode, params, calibration);
+        }
+    }
+    
+    calibration->ta = ta;
+    calibration->vdd = vdd;
+    calibration->mode = mode;
+    calibration->valid = 1;
+    
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90640_CalculateToCalibrated(uint16_t *frameData, const paramsMLX90640 *params, const calibrationMLX90640 *calibration, float emissivity, float tr, float *result)
+{
+    float vdd;
+    float ta;
+    float ta4;
+    float tr4;
+    float taTr;
+    float gain;
+    float irDataCP;
+    float irData;
+    float irDataScaled;
+    float ksToScale;
+    float To;
+    float alphaCorrR[4];
+    int8_t range;
+    uint8_t mode;
+    uint16_t subPage;
+    uint16_t pixelNumber;
+    const uint16_t *pixels;
+    const float *offsetComp;
+    const float *alphaComp;
+    
+    subPage = frameData[833];
+    if(subPage > 1)
+    {
+        return;
+    }
+    
+    pixels = calibration->pixels[subPage];
+    offsetComp = calibration->offsetComp[subPage];
+    alphaComp = calibration->alphaComp[subPage];
+    mode = (frameData[832] & 0x1000) >> 5;
+    vdd = MLX90640_GetVdd(frameData, params);
+    ta = MLX90640_GetTa(frameData, params);
+    ta4 = (ta + 273.15f) * (ta + 273.15f);
+    ta4 = ta4 * ta4;
+    tr4 = (tr + 273.15f) * (tr + 273.15f);
+    tr4 = tr4 * tr4;
+    taTr = tr4 - (tr4-ta4)/emissivity;
+    
+    alphaCorrR[0] = 1 / (1 + params->ksTo[0] * 40);
+    alphaCorrR[1] = 1 ;
+    alphaCorrR[2] = (1 + params->ksTo[2] * params->ct[2]);
+    alphaCorrR[3] = alphaCorrR[2] * (1 + params->ksTo[3] * (params->ct[3] - params->ct[2]));
+    
+//------------------------- Gain calculation -----------------------------------    
+    gain = params->gainEE / (float)(int16_t)frameData[778];
+  
+//------------------------- To calculation -------------------------------------    
+    irDataCP = (int16_t)frameData[subPage == 0 ? 776 : 808] * gain;
+    if(subPage == 0 || mode == params->calibrationModeEE)
+    {
+        irDataCP = irDataCP - params->cpOffset[subPage] * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3f));
+    }
+    else
+    {
+        irDataCP = irDataCP - (params->cpOffset[1] + params->ilChessC[0]) * (1 + params->cpKta * (ta - 25)) * (1 + params->cpKv * (vdd - 3.3f));
+    }
+
+    for( int i = 0; i < 384; i++)
+    {
+        pixelNumber = pixels[i];
+        
+        irData = (int16_t)frameData[pixelNumber] * gain - offsetComp[i];
+        irData = irData / emissivity;
+        irData = irData - params->tgc * irDataCP;
+        
+        // same as the reference with alphaCompensated factored out of Sx:
+        // Sx = ksTo[1] * alphaCompensated * Root4(irData / alphaCompensated + taTr)
+        irDataScaled = irData / alphaComp[i];
+        ksToScale = 1 + params->ksTo[1] * (Root4(irDataScaled + taTr) - 273.15f);
+        
+        To = Root4(irDataScaled / ksToScale + taTr) - 273.15f;
+                
+        if(To < params->ct[1])
+        {
+            range = 0;
+        }
+        else if(To < params->ct[2])   
+        {
+            range = 1;            
+        }   
+        else if(To < params->ct[3])
+        {
+            range = 2;            
+        }
+        else
+        {
+            range = 3;            
+        }      
+        
+        To = Root4(irDataScaled / (alphaCorrR[range] * (1 + params->ksTo[range] * (To - params->ct[range]))) + taTr) - 273.15f;
+        
+        result[pixelNumber] = To;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void AddBadPixel(uint16_t pixel, uint8_t mode, const paramsMLX90640 *params, calibrationMLX90640 *calibration)
+{
+    uint16_t candidates[4];
+    uint8_t candidateCount;
+    uint8_t line;
+    uint8_t column;
+    uint8_t index;
+    
+    line = pixel >> 5;
+    column = pixel & 31;
+    candidateCount = 0;
+    
+    // neighbors of the same subpage: diagonal in chess mode, in the same line in interleaved mode
+    if(mode != 0)
+    {
+        if(line > 0 && column > 0)
+        {
+            candidates[candidateCount++] = pixel - 33;
+        }
+        if(line > 0 && column < 31)
+        {
+            candidates[candidateCount++] = pixel - 31;
+        }
+        if(line < 23 && column > 0)
+        {
+            candidates[candidateCount++] = pixel + 31;
+        }
+        if(line < 23 && column < 31)
+        {
+            candidates[candidateCount++] = pixel + 33;
+        }
+    }
+    else
+    {
+        if(column > 0)
+        {
+            candidates[candidateCount++] = pixel - 1;
+        }
+        if(column < 31)
+        {
+            candidates[candidateCount++] = pixel + 1;
+        }
+    }
+    
+    index = calibration->badPixelCount++;
+    calibration->badPixels[index] = pixel;
+    calibration->badPixelSubPage[index] = mode == 0 ? line & 1 : (line ^ column) & 1;
+    calibration->badPixelNeighborCount[index] = 0;
+    for(int i = 0; i < candidateCount; i++)
+    {
+        if(IsPixelBad(candidates[i], params) == 0)
+        {
+            calibration->badPixelNeighbors[index][calibration->badPixelNeighborCount[index]++] = candidates[i];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void MLX90640_CorrectBadPixelsCalibrated(uint16_t *frameData, const calibrationMLX90640 *calibration, float *result)
+{
+    float ap[4];
+    uint8_t count;
+    
+    for(int i = 0; i < calibration->badPixelCount; i++)
+    {
+        count = calibration->badPixelNeighborCount[i];
+        if(calibration->badPixelSubPage[i] != frameData[833] || count == 0)
+        {
+            continue;
+        }
+        
+        for(int j = 0; j < count; j++)
+        {
+            ap[j] = result[calibration->badPixelNeighbors[i][j]];
+        }
+        
+        if(count == 4)
+        {
+            result[calibration->badPixels[i]] = GetMedian(ap, 4);
+        }
+        else if(count == 3)
+        {
+            result[calibration->badPixels[i]] = (ap[0] + ap[1] + ap[2]) / 3;
+        }
+        else if(count == 2)
+        {
+            result[calibration->badPixels[i]] = (ap[0] + ap[1]) / 2;
+        }
+        else
+        {
+            result[calibration->badPixels[i]] = ap[0];
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
 void MLX90640_GetImage(uint16_t *frameData, const paramsMLX90640 *params, float *result)
 {
     float vdd;
@@ -483,7 +795,7 @@ void MLX90640_GetImage(uint16_t *frameData, const paramsMLX90640 *params, float
             }
             irData = irData * gain;
             
-            irData = irData - params->offset[pixelNumber]*(1 + params->kta[pixelNumber]*(ta - 25))*(1 + params->kv[pixelNumber]*(vdd - 3.3));
+            irData = irData - params->offset[pixelNumber]*(1 + MLX90640_GetKta(params, pixelNumber)*(ta - 25))*(1 + MLX90640_GetKv(params, pixelNumber)*(vdd - 3.3));
             if(mode !=  params->calibrationModeEE)
             {
               irData = irData + params->ilChessC[2] * (2 * ilPattern - 1) - params->ilChessC[1] * conversionPattern; 
@@ -491,7 +803,7 @@ void MLX90640_GetImage(uint16_t *frameData, const paramsMLX90640 *params, float
             
             irData = irData - params->tgc * irDataCP[subPage];
             
-            alphaCompensated = (params->alpha[pixelNumber] - params->tgc * params->cpAlpha[subPage])*(1 + params->KsTa * (ta - 25));
+            alphaCompensated = (MLX90640_GetAlpha(params, pixelNumber) - params->tgc * params->cpAlpha[subPage])*(1 + params->KsTa * (ta - 25));
             
             image = irData/alphaCompensated;
             
@@ -819,6 +1131,10 @@ void ExtractAlphaParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
     uint8_t accRowScale;
     uint8_t accColumnScale;
     uint8_t accRemScale;
+#ifdef MLX90640_COMPACT_PARAMS
+    int alphaPixel;
+    int32_t alphaNumerators[768];
+#endif
     
 
     accRemScale = eeData[32] & 0x000F;
@@ -866,6 +1182,15 @@ void ExtractAlphaParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
         for(int j = 0; j < 32; j ++)
         {
             p = 32 * i +j;
+#ifdef MLX90640_COMPACT_PARAMS
+            alphaPixel = (eeData[64 + p] & 0x03F0) >> 4;
+            if (alphaPixel > 31)
+            {
+                alphaPixel = alphaPixel - 64;
+            }
+            alphaPixel = alphaPixel*(1 << accRemScale);
+            alphaNumerators[p] = alphaRef + (accRow[i] << accRowScale) + (accColumn[j] << accColumnScale) + alphaPixel;
+#else
             mlx90640->alpha[p] = (eeData[64 + p] & 0x03F0) >> 4;
             if (mlx90640->alpha[p] > 31)
             {
@@ -874,8 +1199,12 @@ void ExtractAlphaParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
             mlx90640->alpha[p] = mlx90640->alpha[p]*(1 << accRemScale);
             mlx90640->alpha[p] = (alphaRef + (accRow[i] << accRowScale) + (accColumn[j] << accColumnScale) + mlx90640->alpha[p]);
             mlx90640->alpha[p] = mlx90640->alpha[p] / pow(2,(double)alphaScale);
+#endif
         }
     }
+#ifdef MLX90640_COMPACT_PARAMS
+    CompactArray(alphaNumerators, alphaScale, mlx90640->alpha, &mlx90640->alphaScale);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -963,6 +1292,10 @@ void ExtractKtaPixelParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
     uint8_t ktaScale1;
     uint8_t ktaScale2;
     uint8_t split;
+#ifdef MLX90640_COMPACT_PARAMS
+    int ktaPixel;
+    int32_t ktaNumerators[768];
+#endif
 
     KtaRoCo = (eeData[54] & 0xFF00) >> 8;
     if (KtaRoCo > 127)
@@ -1001,6 +1334,14 @@ void ExtractKtaPixelParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
         {
             p = 32 * i +j;
             split = 2*(p/32 - (p/64)*2) + p%2;
+#ifdef MLX90640_COMPACT_PARAMS
+            ktaPixel = (eeData[64 + p] & 0x000E) >> 1;
+            if (ktaPixel > 3)
+            {
+                ktaPixel = ktaPixel - 8;
+            }
+            ktaNumerators[p] = KtaRC[split] + ktaPixel * (1 << ktaScale2);
+#else
             mlx90640->kta[p] = (eeData[64 + p] & 0x000E) >> 1;
             if (mlx90640->kta[p] > 3)
             {
@@ -1009,8 +1350,12 @@ void ExtractKtaPixelParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
             mlx90640->kta[p] = mlx90640->kta[p] * (1 << ktaScale2);
             mlx90640->kta[p] = KtaRC[split] + mlx90640->kta[p];
             mlx90640->kta[p] = mlx90640->kta[p] / pow(2,(double)ktaScale1);
+#endif
         }
     }
+#ifdef MLX90640_COMPACT_PARAMS
+    CompactArray(ktaNumerators, ktaScale1, mlx90640->kta, &mlx90640->ktaScale);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -1064,10 +1409,49 @@ void ExtractKvPixelParameters(uint16_t *eeData, paramsMLX90640 *mlx90640)
             p = 32 * i +j;
             split = 2*(p/32 - (p/64)*2) + p%2;
             mlx90640->kv[p] = KvT[split];
+#ifndef MLX90640_COMPACT_PARAMS
             mlx90640->kv[p] = mlx90640->kv[p] / pow(2,(double)kvScale);
+#endif
         }
     }
+#ifdef MLX90640_COMPACT_PARAMS
+    mlx90640->kvScale = kvScale;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+#ifdef MLX90640_COMPACT_PARAMS
+// Stores numerators * 2^-scale as int16, dropping low bits if the numerators exceed the int16 range
+void CompactArray(const int32_t *numerators, uint8_t scale, int16_t *values, uint8_t *valuesScale)
+{
+    int32_t maxMagnitude = 0;
+    uint8_t shift = 0;
+    
+    for(int i = 0; i < 768; i++)
+    {
+        if(numerators[i] > maxMagnitude)
+        {
+            maxMagnitude = numerators[i];
+        }
+        else if(-numerators[i] > maxMagnitude)
+        {
+            maxMagnitude = -numerators[i];
+        }
+    }
+    
+    while((maxMagnitude >> shift) > 32767)
+    {
+        shift = shift + 1;
+    }
+    
+    for(int i = 0; i < 768; i++)
+    {
+        values[i] = numerators[i] >> shift;
+    }
+    *valuesScale = scale - shift;
 }
+#endif
 
 //------------------------------------------------------------------------------
 
@@ -1330,7 +1714,7 @@ float GetMedian(float *values, int n)
 
 //------------------------------------------------------------------------------
 
-int IsPixelBad(uint16_t pixel,paramsMLX90640 *params)
+int IsPixelBad(uint16_t pixel,const paramsMLX90640 *params)
 {
     for(int i=0; i<5; i++)
     {
@@ -16,6 +16,14 @@
  */
 #ifndef _MLX640_API_H_
 #define _MLX640_API_H_
+
+#include <math.h>
+#include <stdint.h>
+
+// replaces the sqrtf based fourth roots of MLX90640_CalculateToCalibrated by a Newton iteration
+//#define MLX90640_APPROXIMATE_ROOT
+// stores alpha, kta and kv as int16 with a power of two scale per array instead of float, saves 4.5 KB
+//#define MLX90640_COMPACT_PARAMS
     
   typedef struct
     {
@@ -34,10 +42,20 @@
         float KsTa;
         float ksTo[4];
         int16_t ct[4];
+#ifdef MLX90640_COMPACT_PARAMS
+        int16_t alpha[768];         // alpha[i] * 2^-alphaScale, read with MLX90640_GetAlpha
+        int16_t offset[768];    
+        int16_t kta[768];           // kta[i] * 2^-ktaScale, read with MLX90640_GetKta
+        int16_t kv[768];            // kv[i] * 2^-kvScale, read with MLX90640_GetKv
+        uint8_t alphaScale;
+        uint8_t ktaScale;
+        uint8_t kvScale;
+#else
         float alpha[768];    
         int16_t offset[768];    
         float kta[768];    
         float kv[768];
+#endif
         float cpAlpha[2];
         int16_t cpOffset[2];
         float ilChessC[3]; 
@@ -45,13 +63,43 @@
         uint16_t outlierPixels[5];  
     } paramsMLX90640;
     
+  typedef struct
+    {
+        uint16_t pollCount; // status register reads until a new subpage was available
+        uint8_t readCount;  // frame reads until the subpage was not overwritten during the read
+    } frameStatsMLX90640;
+    
+  // Per-pixel compensation terms of MLX90640_CalculateTo that only depend on the parameters,
+  // the mode and the slowly changing Ta and Vdd. Rebuilt by MLX90640_UpdateCalibration.
+  typedef struct
+    {
+        float ta;                   // Ta and Vdd the terms were computed for
+        float vdd;
+        uint8_t mode;               // chess or interleaved mode the terms were computed for
+        uint8_t valid;
+        uint16_t pixels[2][384];    // pixel numbers of each subpage, the terms below are in the same order
+        float offsetComp[2][384];   // offset * (1 + kta * (Ta - 25)) * (1 + kv * (Vdd - 3.3)) minus the IL chess correction
+        float alphaComp[2][384];    // (alpha - tgc * cpAlpha) * (1 + KsTa * (Ta - 25))
+        uint8_t badPixelCount;      // broken and outlier pixels, replaced by their neighbors of the same subpage
+        uint16_t badPixels[10];
+        uint8_t badPixelSubPage[10];
+        uint8_t badPixelNeighborCount[10];
+        uint16_t badPixelNeighbors[10][4];
+    } calibrationMLX90640;
+    
+#define MLX90640_CALIBRATION_TA_DRIFT  0.1f    // rebuild the calibration if Ta drifted by more than this, in degree Celsius
+#define MLX90640_CALIBRATION_VDD_DRIFT 0.002f  // rebuild the calibration if Vdd drifted by more than this, in Volt
+    
     int MLX90640_DumpEE(uint8_t slaveAddr, uint16_t *eeData);
-    int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData);
+    int MLX90640_GetFrameData(uint8_t slaveAddr, uint16_t *frameData, frameStatsMLX90640 *stats);
     int MLX90640_ExtractParameters(uint16_t *eeData, paramsMLX90640 *mlx90640);
     float MLX90640_GetVdd(uint16_t *frameData, const paramsMLX90640 *params);
     float MLX90640_GetTa(uint16_t *frameData, const paramsMLX90640 *params);
     void MLX90640_GetImage(uint16_t *frameData, const paramsMLX90640 *params, float *result);
     void MLX90640_CalculateTo(uint16_t *frameData, const paramsMLX90640 *params, float emissivity, float tr, float *result);
+    int MLX90640_UpdateCalibration(uint16_t *frameData, const paramsMLX90640 *params, calibrationMLX90640 *calibration);
+    void MLX90640_CalculateToCalibrated(uint16_t *frameData, const paramsMLX90640 *params, const calibrationMLX90640 *calibration, float emissivity, float tr, float *result);
+    void MLX90640_CorrectBadPixelsCalibrated(uint16_t *frameData, const calibrationMLX90640 *calibration, float *result);
     int MLX90640_SetResolution(uint8_t slaveAddr, uint8_t resolution);
     int MLX90640_GetCurResolution(uint8_t slaveAddr);
     int MLX90640_SetRefreshRate(uint8_t slaveAddr, uint8_t refreshRate);   
@@ -62,4 +110,14 @@
     int MLX90640_SetChessMode(uint8_t slaveAddr);
     void MLX90640_BadPixelsCorrection(uint16_t *pixels, float *to, int mode, paramsMLX90640 *params);
     
+#ifdef MLX90640_COMPACT_PARAMS
+    static inline float MLX90640_GetAlpha(const paramsMLX90640 *params, int pixel) { return ldexpf(params->alpha[pixel], -params->alphaScale); }
+    static inline float MLX90640_GetKta(const paramsMLX90640 *params, int pixel) { return ldexpf(params->kta[pixel], -params->ktaScale); }
+    static inline float MLX90640_GetKv(const paramsMLX90640 *params, int pixel) { return ldexpf(params->kv[pixel], -params->kvScale); }
+#else
+    static inline float MLX90640_GetAlpha(const paramsMLX90640 *params, int pixel) { return params->alpha[pixel]; }
+    static inline float MLX90640_GetKta(const paramsMLX90640 *params, int pixel) { return params->kta[pixel]; }
+    static inline float MLX90640_GetKv(const paramsMLX90640 *params, int pixel) { return params->kv[pixel]; }
+#endif
+    
 #endif
@@ -28,24 +28,37 @@ void MLX90640_I2CInit()
 
 //Read a number of words from startAddress. Store into Data array.
 //Returns 0 if successful, -1 if error
+//The words are read in chunks that fit into the Wire buffer and byte swapped while they are
+//taken from it, sensor Big Endian, ESP32 Little Endian
 int MLX90640_I2CRead(uint8_t _deviceAddress, unsigned int startAddress, unsigned int nWordsRead, uint16_t *data)
 {
-  // nWordsRead must be <= 32767
+  //requestFrom takes the byte count as uint8_t, larger Wire buffers are used up to 127 words
+  const unsigned int maxChunkWords = (I2C_BUFFER_LENGTH < 256 ? I2C_BUFFER_LENGTH : 255) / 2;
+
+  while (nWordsRead > 0)
+  {
+    const unsigned int chunkWords = nWordsRead < maxChunkWords ? nWordsRead : maxChunkWords;
+
     Wire.beginTransmission(_deviceAddress);
     Wire.write(startAddress >> 8); //MSB
     Wire.write(startAddress & 0xFF); //LSB
-    Wire.endTransmission(false);
-    i2c_err_t error = Wire.readTransmission(_deviceAddress, (uint8_t*) data, nWordsRead*2);
-    if(error != 0){//problems
-        Serial.printf("Block read from sensor(0x%02X) at address=%d of %d uint16_t's failed=%d(%s)\n",
-        _deviceAddress,startAddress,nWordsRead,error,Wire.getErrorText(error));
-    }
-    else { // reverse byte order, sensor Big Endian, ESP32 Little Endian
-        for(auto a = 0; a<nWordsRead; a++){
-            data[a] = ((data[a] & 0xff)<<8) | (( data[a]>>8)&0xff);
-        }
+    Wire.endTransmission(false); // repeated start, errors show up in requestFrom
+
+    if (Wire.requestFrom(_deviceAddress, (uint8_t)(chunkWords * 2)) != chunkWords * 2)
+      return -1;
+
+    for (unsigned int i = 0; i < chunkWords; i++)
+    {
+      const uint8_t msb = Wire.read();
+      const uint8_t lsb = Wire.read();
+      *data++ = (msb << 8) | lsb;
     }
-    return 0;
+
+    startAddress += chunkWords;
+    nWordsRead -= chunkWords;
+  }
+
+  return 0;
 }
 
 
@@ -73,7 +86,9 @@ int MLX90640_I2CWrite(uint8_t _deviceAddress, unsigned int writeAddress, uint16_
   }
 
   uint16_t dataCheck;
-  MLX90640_I2CRead(_deviceAddress, writeAddress, 1, &dataCheck);
+  if (MLX90640_I2CRead(_deviceAddress, writeAddress, 1, &dataCheck) != 0)
+    return -1;
+
   if (dataCheck != data)
   {
     //Serial.println("The write request didn't stick");
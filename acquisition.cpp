@@ -0,0 +1,79 @@
+#include "acquisition.h"
+
+#include <Arduino.h>
+#include <algorithm>
+
+void AcquisitionScheduler::setPeriod(uint32_t _periodMicros)
+{
+  periodMicros = _periodMicros;
+  scheduled = false;
+}
+
+void AcquisitionScheduler::resetTiming()
+{
+  minCallMicros = UINT32_MAX;
+  scheduled = false;
+}
+
+void AcquisitionScheduler::sleepUntilDue()
+{
+  const uint32_t now = micros();
+  if (errorBackOffMillis > 0)
+  {
+    vTaskDelay(std::max<TickType_t>(pdMS_TO_TICKS(errorBackOffMillis), 1));
+    stats.sleepMicros += micros() - now;
+    return;
+  }
+
+  if (!scheduled)
+    return;
+
+  const int32_t remainingMicros = nextWakeMicros - now;
+  if (remainingMicros >= 1000)
+  {
+    vTaskDelay(pdMS_TO_TICKS(remainingMicros / 1000));
+    stats.sleepMicros += micros() - now;
+  }
+}
+
+void AcquisitionScheduler::update(uint32_t callStart, uint32_t callEnd, int status, const frameStatsMLX90640& frameStats)
+{
+  const uint32_t callMicros = callEnd - callStart;
+
+  stats.subPages++;
+  stats.polls += frameStats.pollCount;
+  stats.retries += frameStats.readCount > 1 ? frameStats.readCount - 1 : 0;
+  stats.readMicros += callMicros;
+
+  if (status < 0)
+  {
+    stats.errors++;
+    if (status == -8)
+      stats.timeouts++;
+
+    // poll for the next subpage to find the sensor timing again, after a pause
+    scheduled = false;
+    errorBackOffMillis = errorBackOffMillis == 0 ? 1 : std::min(2 * errorBackOffMillis, MaxErrorBackOffMillis);
+    return;
+  }
+
+  errorBackOffMillis = 0;
+
+  if (periodMicros == 0)
+    return;
+
+  if (frameStats.pollCount <= 1)
+  {
+    // the subpage was ready before the call, so the next one is due a period after callStart at the latest
+    if (callMicros < minCallMicros)
+      minCallMicros = callMicros;
+    nextWakeMicros = callStart + periodMicros - WakeMarginMicros;
+  }
+  else
+  {
+    // the subpage got ready while polling, right before the read itself started
+    const uint32_t readyMicros = minCallMicros < callMicros ? callEnd - minCallMicros : callStart;
+    nextWakeMicros = readyMicros + periodMicros - WakeMarginMicros;
+  }
+  scheduled = true;
+}
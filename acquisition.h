@@ -0,0 +1,51 @@
+#ifndef H_ACQUISITION
+#define H_ACQUISITION
+
+#include "MLX90640_API.h"
+
+#include <stdint.h>
+
+struct AcquisitionStats
+{
+  uint32_t subPages = 0;
+  uint32_t errors = 0;      // failed reads, including timeouts
+  uint32_t timeouts = 0;    // subpage was overwritten during every read attempt
+  uint32_t polls = 0;       // status register reads
+  uint32_t retries = 0;     // repeated frame reads
+  uint32_t sleepMicros = 0; // time slept until a subpage was due
+  uint32_t readMicros = 0;  // time spent in MLX90640_GetFrameData, polling included
+};
+
+// Predicts when the sensor finishes the next subpage from its refresh period, so the sensor task
+// can sleep instead of polling the status register over I2C. The prediction is corrected by every
+// read: if the subpage was already waiting the task woke up too late and the schedule moves earlier,
+// otherwise it locks on to the moment polling saw the data ready. Polling remains as fallback
+// whenever the schedule is unknown or off. After a failed read the task sleeps at least a tick,
+// doubling with every consecutive failure, so a dead bus does not keep it busy.
+class AcquisitionScheduler
+{
+public:
+  void setPeriod(uint32_t periodMicros);
+  // the duration of a read changed, e.g. with the I2C clock
+  void resetTiming();
+
+  void sleepUntilDue();
+  void update(uint32_t callStart, uint32_t callEnd, int status, const frameStatsMLX90640& frameStats);
+
+  const AcquisitionStats& getStats() const { return stats; }
+  void resetStats() { stats = AcquisitionStats(); }
+
+private:
+  static constexpr uint32_t WakeMarginMicros = 1000;
+  static constexpr uint32_t MaxErrorBackOffMillis = 256;
+
+  uint32_t periodMicros = 0;
+  bool scheduled = false;
+  uint32_t nextWakeMicros = 0;
+  uint32_t minCallMicros = UINT32_MAX; // duration of a read without waiting
+  uint32_t errorBackOffMillis = 0;     // sleep before the next read, 0 after a good one
+
+  AcquisitionStats stats;
+};
+
+#endif
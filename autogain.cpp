@@ -0,0 +1,47 @@
+#include "autogain.h"
+
+#include <math.h>
+
+void AutoGain::setPercentiles(float low, float high)
+{
+  lowPercentile = low;
+  highPercentile = high;
+  valid = false;
+}
+
+// first bin whose cumulative count exceeds the given fraction of all values
+int AutoGain::findBin(const FrameStats& stats, float percentile)
+{
+  const uint32_t target = uint32_t(percentile * stats.count);
+  uint32_t cumulative = 0;
+  for (int bin = 0; bin < FrameStats::NumBins; bin++)
+  {
+    cumulative += stats.histogram[bin];
+    if (cumulative > target)
+      return bin;
+  }
+  return FrameStats::NumBins - 1;
+}
+
+bool AutoGain::update(const FrameStats& stats)
+{
+  if (stats.count == 0)
+    return false;
+
+  float low  = FrameStats::getBinTemp(findBin(stats, lowPercentile));
+  float high = FrameStats::getBinTemp(findBin(stats, highPercentile) + 1);
+  if (high - low < MinSpan)
+  {
+    const float center = (low + high) * 0.5f;
+    low  = center - MinSpan * 0.5f;
+    high = center + MinSpan * 0.5f;
+  }
+
+  if (valid && fabsf(low - minTemp) <= hysteresis && fabsf(high - maxTemp) <= hysteresis)
+    return false;
+
+  minTemp = low;
+  maxTemp = high;
+  valid = true;
+  return true;
+}
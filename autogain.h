@@ -0,0 +1,38 @@
+#ifndef H_AUTOGAIN
+#define H_AUTOGAIN
+
+#include "framestats.h"
+
+// Picks the displayed temperature range from percentiles of the image histogram instead of its
+// min and max, so a few hot or cold pixels do not stretch the palette. The range only moves when
+// a percentile leaves the hysteresis band around it, which keeps the contrast stable and the
+// palette is not rebuilt every frame.
+class AutoGain
+{
+public:
+  void setPercentiles(float low, float high);
+  void setHysteresis(float celsius) { hysteresis = celsius; }
+  // the next update takes the range of the histogram regardless of the hysteresis
+  void invalidate() { valid = false; }
+
+  // returns true if the range moved
+  bool update(const FrameStats& stats);
+  float getMinTemp() const { return minTemp; }
+  float getMaxTemp() const { return maxTemp; }
+
+private:
+  static int findBin(const FrameStats& stats, float percentile);
+
+  // the range is never narrower, so sensor noise is not stretched over the whole palette
+  static constexpr float MinSpan = 2.f;
+
+  float lowPercentile = 0.01f;
+  float highPercentile = 0.99f;
+  float hysteresis = 1.f;
+
+  bool valid = false;
+  float minTemp = 0.f;
+  float maxTemp = 0.f;
+};
+
+#endif
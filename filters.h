@@ -1,7 +1,7 @@
 #ifndef H_FILTERS
 #define H_FILTERS
 
-#include <Arduino.h>
+#include <stdint.h>
 
 class KalmanFilter
 {
@@ -41,4 +41,10 @@ inline float filterExponentional(float measurement, float lastFilteredValue, flo
   return measurement * smoothingFactor + lastFilteredValue * (1.f - smoothingFactor);
 };
 
+// fixed point variant, the smoothing factor is applied in Q8
+inline int16_t filterExponentional(int16_t measurement, int16_t lastFilteredValue, float smoothingFactor) {
+  const int32_t factor = int32_t(smoothingFactor * 256.f + 0.5f);
+  return lastFilteredValue + (((measurement - lastFilteredValue) * factor + 128) >> 8);
+};
+
 #endif
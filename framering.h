@@ -0,0 +1,88 @@
+#ifndef H_FRAMERING
+#define H_FRAMERING
+
+#include "spscqueue.h"
+
+#include <array>
+#include <atomic>
+#include <stdint.h>
+
+struct alignas(SpscCacheLineSize) SensorFrame
+{
+  static constexpr int RawWords  = 834;
+  static constexpr int NumPixels = 768;
+
+  std::array<uint16_t, RawWords> raw;  // last subpage as read by MLX90640_GetFrameData
+  std::array<float, NumPixels> pixels; // object temperatures computed by MLX90640_CalculateTo, only subPage pixels in single subpage mode
+  uint32_t timestamp = 0;              // acquisition time in milliseconds
+  uint32_t sequence = 0;               // consecutive number of every acquired frame, including dropped ones
+  uint8_t subPage = 0;                 // subpage of raw
+};
+
+// Hands sensor frames from one producer task to one consumer task without locks or copies.
+// The producer always gets a slot to write into: if the consumer fell behind and the ring
+// is full, a spare slot is used and the frame is dropped when it is committed. The consumer
+// either looks at the latest frame only, older unread frames are counted as overwritten,
+// or reads every frame in order.
+template<size_t Capacity>
+class FrameRing
+{
+public:
+  // producer side
+  SensorFrame& beginWrite()
+  {
+    writing = queue.back();
+    if (writing == nullptr)
+      writing = &spare;
+    return *writing;
+  }
+
+  void endWrite(uint32_t timestamp)
+  {
+    writing->timestamp = timestamp;
+    writing->sequence = nextSequence++;
+
+    if (writing == &spare)
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    else
+      queue.push();
+  }
+
+  // consumer side, returns nullptr if there is no new frame, otherwise the frame stays valid until release()
+  const SensorFrame* readLatest()
+  {
+    while (queue.size() > 1)
+    {
+      queue.pop();
+      overwritten.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queue.front();
+  }
+
+  // consumer side, returns the oldest unread frame or nullptr, the frame stays valid until release()
+  const SensorFrame* readNext()
+  {
+    return queue.front();
+  }
+
+  void release()
+  {
+    queue.pop();
+  }
+
+  uint32_t getDroppedFrames() const { return dropped.load(std::memory_order_relaxed); }
+  uint32_t getOverwrittenFrames() const { return overwritten.load(std::memory_order_relaxed); }
+
+private:
+  SpscQueue<SensorFrame, Capacity> queue;
+
+  // written by the producer only
+  SensorFrame spare;
+  SensorFrame *writing = nullptr;
+  uint32_t nextSequence = 0;
+
+  std::atomic<uint32_t> dropped{0};
+  std::atomic<uint32_t> overwritten{0};
+};
+
+#endif
@@ -0,0 +1,9 @@
+#include "framestats.h"
+
+#include <string.h>
+
+void FrameStats::clear()
+{
+  count = 0;
+  memset(histogram.data(), 0, sizeof(histogram));
+}
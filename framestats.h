@@ -0,0 +1,50 @@
+#ifndef H_FRAMESTATS
+#define H_FRAMESTATS
+
+#include "temperature.h"
+
+#include <array>
+#include <stdint.h>
+
+// Statistics of the filtered image, collected by the denoising pass in the same walk over the
+// pixels, so the dynamic range and the equalized palette do not have to scan the image again.
+struct FrameStats
+{
+  // histogram bins of a quarter degree over the -40 to 300 degree Celsius range of the sensor,
+  // values outside go to the outer bins
+  static constexpr int BinsPerDegree = 4;
+  static constexpr int MinBinTemp = -40;
+  static constexpr int MaxBinTemp = 300;
+  static constexpr int NumBins = (MaxBinTemp - MinBinTemp) * BinsPerDegree;
+
+  uint32_t count = 0;
+  std::array<uint16_t, NumBins> histogram;
+
+  void clear();
+
+  void add(Temperature value)
+  {
+    count++;
+    histogram[getBin(value)]++;
+  }
+
+  static int getBin(Temperature value)
+  {
+#ifdef FIXED_POINT_PIPELINE
+    const int32_t bin = (int32_t(value) - MinBinTemp * 100) * BinsPerDegree / 100;
+#else
+    const float offset = (value - MinBinTemp) * BinsPerDegree;
+    const int32_t bin = offset <= 0.f ? 0 : int32_t(offset);
+#endif
+    if (bin < 0)
+      return 0;
+    if (bin >= NumBins)
+      return NumBins - 1;
+    return bin;
+  }
+
+  // lower edge of a bin in degree Celsius
+  static float getBinTemp(int bin) { return MinBinTemp + float(bin) / BinsPerDegree; }
+};
+
+#endif
@@ -0,0 +1,53 @@
+// Runs the sketch on the host against the simulated sensor until the recording was replayed,
+// then saves the screen. The serial commands arrive one character per loop(), like typed ones.
+//
+//   thermocam_host [recording] [repeats] [screenshot.ppm] [serial command]...
+
+#include "simulatedsensor.h"
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+#include <stdlib.h>
+#include <string>
+
+extern TFT_eSPI tft;
+
+void setup();
+void loop();
+
+int main(int argc, char **argv)
+{
+  const char *recordingPath = argc > 1 ? argv[1] : HOST_DATA_DIR "/scene.rec";
+  const int repeats = argc > 2 ? atoi(argv[2]) : 8;
+  const char *screenshotPath = argc > 3 ? argv[3] : "thermocam.ppm";
+
+  SimulatedSensor& sensor = SimulatedSensor::instance();
+  if (!sensor.load(recordingPath))
+  {
+    fprintf(stderr, "failed to load %s\n", recordingPath);
+    return 1;
+  }
+  sensor.setRepeats(repeats);
+
+  std::string input;
+  for (int i = 4; i < argc; i++)
+    input += std::string(argv[i]) + "\n";
+
+  setup();
+
+  for (size_t i = 0; !sensor.isFinished(); i++)
+  {
+    if (i < input.size())
+      Serial.receive(input.substr(i, 1).c_str());
+    loop();
+  }
+  loop(); // draws the last frame
+
+  if (!tft.writePPM(screenshotPath))
+  {
+    fprintf(stderr, "failed to write %s\n", screenshotPath);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "recording.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+  const int WordsPerLine = 16;
+
+  bool readWords(FILE *file, uint16_t *words, int count) {
+    for (int i = 0; i < count; i++)
+    {
+      unsigned int word = 0;
+      if (fscanf(file, "%x", &word) != 1 || word > 0xFFFF)
+        return false;
+      words[i] = word;
+    }
+    return true;
+  }
+
+  void writeWords(FILE *file, const uint16_t *words, int count) {
+    for (int i = 0; i < count; i++)
+      fprintf(file, "%04X%c", words[i], (i % WordsPerLine == WordsPerLine - 1 || i == count - 1) ? '\n' : ' ');
+  }
+}
+
+bool Recording::load(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  if (file == nullptr)
+    return false;
+
+  bool hasEeprom = false;
+  bool valid = true;
+  frames.clear();
+
+  char token[64];
+  while (valid && fscanf(file, "%63s", token) == 1)
+  {
+    if (token[0] == '#')
+    {
+      int c;
+      while ((c = fgetc(file)) != EOF && c != '\n');
+    }
+    else if (strcmp(token, "eeprom") == 0)
+    {
+      valid = readWords(file, eeprom.data(), EepromWords);
+      hasEeprom = true;
+    }
+    else if (strcmp(token, "frame") == 0)
+    {
+      frames.emplace_back();
+      valid = readWords(file, frames.back().data(), FrameWords);
+    }
+    else
+    {
+      valid = false;
+    }
+  }
+
+  fclose(file);
+  return valid && hasEeprom;
+}
+
+bool Recording::save(const char *path, const char *comment) const
+{
+  FILE *file = fopen(path, "w");
+  if (file == nullptr)
+    return false;
+
+  if (comment != nullptr)
+    fprintf(file, "# %s\n", comment);
+
+  fprintf(file, "eeprom\n");
+  writeWords(file, eeprom.data(), EepromWords);
+  for (const Frame& frame : frames)
+  {
+    fprintf(file, "frame\n");
+    writeWords(file, frame.data(), FrameWords);
+  }
+
+  return fclose(file) == 0;
+}
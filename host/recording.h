@@ -0,0 +1,25 @@
+#ifndef H_RECORDING
+#define H_RECORDING
+
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+// EEPROM dump and subpage frames of an MLX90640 as returned by MLX90640_DumpEE and MLX90640_GetFrameData,
+// stored as text: an "eeprom" line followed by its 832 hex words, then a "frame" line followed by
+// 834 hex words per subpage. Lines starting with # are comments.
+struct Recording
+{
+  static constexpr int EepromWords = 832;
+  static constexpr int FrameWords  = 834;
+
+  typedef std::array<uint16_t, FrameWords> Frame;
+
+  std::array<uint16_t, EepromWords> eeprom;
+  std::vector<Frame> frames;
+
+  bool load(const char *path);
+  bool save(const char *path, const char *comment = nullptr) const;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "simulatedsensor.h"
+
+#include <Arduino.h>
+
+SimulatedSensor& SimulatedSensor::instance()
+{
+  // never destroyed, the sensor task may still poll while the process exits
+  static SimulatedSensor *sensor = new SimulatedSensor();
+  return *sensor;
+}
+
+SimulatedSensor::SimulatedSensor()
+{
+  recording.eeprom.fill(0);
+}
+
+bool SimulatedSensor::load(const char *path)
+{
+  Recording loaded;
+  if (!loaded.load(path))
+    return false;
+
+  setRecording(loaded);
+  return true;
+}
+
+void SimulatedSensor::setRecording(const Recording& _recording)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  recording = _recording;
+  restart();
+}
+
+void SimulatedSensor::setRepeats(int _repeats)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  repeats = _repeats;
+  restart();
+}
+
+void SimulatedSensor::setConnected(bool _connected)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  connected = _connected;
+
+  // a subpage taken but not read yet is lost, the next one gets ready as usual
+  if (!connected)
+    readFrame = frame;
+}
+
+bool SimulatedSensor::isConnected() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return connected;
+}
+
+bool SimulatedSensor::isFinished() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return readFrame == int(recording.frames.size()) * repeats - 1;
+}
+
+uint32_t SimulatedSensor::getTransfers() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return transfers;
+}
+
+// the control register is loaded from the EEPROM at power up
+void SimulatedSensor::restart()
+{
+  control = recording.eeprom[ControlEeprom] != 0 ? recording.eeprom[ControlEeprom] : 0x1901;
+  status = 0;
+  started = false;
+  frame = -1;
+  readFrame = -1;
+}
+
+uint32_t SimulatedSensor::getPeriodMicros() const
+{
+  // subpage rate of 0.5 Hz * 2^refresh rate
+  return 2000000 >> ((control >> 7) & 0x07);
+}
+
+// the next subpage becomes ready a period after the last one, but not before the last one was read
+void SimulatedSensor::update(uint32_t nowMicros)
+{
+  if (!started)
+  {
+    started = true;
+    nextReadyMicros = nowMicros + getPeriodMicros();
+  }
+
+  const int numFrames = int(recording.frames.size()) * repeats;
+  if ((status & DataReady) || frame + 1 >= numFrames || readFrame != frame || int32_t(nowMicros - nextReadyMicros) < 0)
+    return;
+
+  frame++;
+  const Recording::Frame& data = recording.frames[frame % recording.frames.size()];
+  status = (status & ~0x0001) | (data[833] & 0x0001) | DataReady;
+  nextReadyMicros += getPeriodMicros();
+}
+
+uint16_t SimulatedSensor::readRegister(uint16_t address) const
+{
+  if (address >= EepromAddress && address < EepromAddress + Recording::EepromWords)
+    return recording.eeprom[address - EepromAddress];
+
+  if (address >= RamAddress && address < RamAddress + RamWords)
+    return frame < 0 ? 0 : recording.frames[frame % recording.frames.size()][address - RamAddress];
+
+  if (address == StatusRegister)
+    return status;
+
+  if (address == ControlRegister)
+    return control;
+
+  return 0;
+}
+
+bool SimulatedSensor::read(uint16_t address, uint16_t *data, size_t words, uint32_t clock)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  transfers++;
+  if (!connected)
+    return false;
+
+  const uint32_t now = micros();
+  if (address == StatusRegister)
+    update(now);
+
+  for (size_t i = 0; i < words; i++)
+    data[i] = readRegister(address + i);
+
+  // a subpage counts as read once its RAM was read completely after the data ready flag was cleared
+  if (frame >= 0 && !(status & DataReady) && address < RamAddress + RamWords && address + words >= RamAddress + RamWords)
+  {
+    readFrame = frame;
+    if (int32_t(now + getPeriodMicros() / 2 - nextReadyMicros) > 0)
+      nextReadyMicros = now + getPeriodMicros() / 2;
+  }
+  return true;
+}
+
+bool SimulatedSensor::write(uint16_t address, uint16_t value)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  transfers++;
+  if (!connected)
+    return false;
+
+  if (address == StatusRegister)
+    status = (status & 0x0001) | (value & ~0x0001);
+  else if (address == ControlRegister)
+    control = value;
+  return true;
+}
@@ -0,0 +1,67 @@
+#ifndef H_SIMULATEDSENSOR
+#define H_SIMULATEDSENSOR
+
+#include "recording.h"
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+// The MLX90640 behind the host Wire stand-in, serving EEPROM, RAM, status and control register
+// from a Recording. Subpages become ready one refresh period after each other, but in order and
+// without loss: a subpage is not replaced before it was read, so a replay feeds the pipeline the
+// same sequence however the host schedules the threads.
+class SimulatedSensor
+{
+public:
+  static constexpr uint8_t Address = 0x33;
+
+  static SimulatedSensor& instance();
+
+  bool load(const char *path);
+  void setRecording(const Recording& recording);
+  // replays the frames this many times
+  void setRepeats(int repeats);
+  // a disconnected sensor does not acknowledge any transfer and loses the subpage being read
+  void setConnected(bool connected);
+
+  bool isConnected() const;
+  // every subpage of the replay was read
+  bool isFinished() const;
+  uint32_t getTransfers() const;
+
+  // bus side, false if the sensor does not acknowledge
+  bool read(uint16_t address, uint16_t *data, size_t words, uint32_t clock);
+  bool write(uint16_t address, uint16_t value);
+
+private:
+  SimulatedSensor();
+
+  void restart();
+  void update(uint32_t nowMicros);
+  uint32_t getPeriodMicros() const;
+  uint16_t readRegister(uint16_t address) const;
+
+  static constexpr uint16_t EepromAddress  = 0x2400;
+  static constexpr uint16_t RamAddress     = 0x0400;
+  static constexpr uint16_t RamWords       = 832;
+  static constexpr uint16_t StatusRegister = 0x8000;
+  static constexpr uint16_t ControlRegister = 0x800D;
+  static constexpr uint16_t DataReady      = 0x0008;
+  static constexpr uint16_t ControlEeprom  = 0x000C;  // power up value of the control register
+
+  mutable std::mutex mutex;
+  Recording recording;
+  int repeats = 1;
+  bool connected = true;
+  uint32_t transfers = 0;
+
+  uint16_t control = 0x1901;
+  uint16_t status = 0;
+  bool started = false;
+  int frame = -1;         // of the replay, -1 before the first one
+  int readFrame = -1;     // last one whose RAM was read after it was taken
+  uint32_t nextReadyMicros = 0;
+};
+
+#endif
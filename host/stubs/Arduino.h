@@ -0,0 +1,69 @@
+#ifndef H_HOST_ARDUINO
+#define H_HOST_ARDUINO
+
+// Host stand-in for the parts of the ESP32 Arduino core the sketch uses
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef uint8_t byte;
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int analogRead(uint8_t pin);
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t print(const char *text);
+  size_t print(char c);
+  size_t print(int value);
+  size_t print(unsigned int value);
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(double value, int digits = 2);
+  size_t println(const char *text = "");
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// writes to stdout, input is fed by the host program with receive()
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+
+  size_t write(uint8_t c) override;
+
+  int available();
+  int read();
+  size_t readBytesUntil(char terminator, char *buffer, size_t length);
+
+  // host only
+  void receive(const char *text);
+
+private:
+  std::mutex mutex;
+  std::string input;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef H_HOST_PREFERENCES
+#define H_HOST_PREFERENCES
+
+// Host stand-in for the ESP32 Preferences library, the namespaces live in memory for the lifetime of the process
+
+#include <Arduino.h>
+
+#include <string>
+
+class Preferences
+{
+public:
+  bool begin(const char *name, bool readOnly = false);
+  void end();
+
+  bool clear();
+  bool remove(const char *key);
+
+  size_t putBytes(const char *key, const void *value, size_t length);
+  size_t getBytesLength(const char *key);
+  size_t getBytes(const char *key, void *buffer, size_t maxLength);
+
+private:
+  std::string name;
+  bool readOnly = false;
+  bool started = false;
+};
+
+#endif
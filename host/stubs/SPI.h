@@ -0,0 +1,6 @@
+#ifndef H_HOST_SPI
+#define H_HOST_SPI
+
+// the display stand-in does not use a bus
+
+#endif
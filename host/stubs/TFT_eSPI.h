@@ -0,0 +1,68 @@
+#ifndef H_HOST_TFT_ESPI
+#define H_HOST_TFT_ESPI
+
+// Host stand-in for TFT_eSPI drawing into an RGB565 framebuffer. Text only moves the cursor,
+// glyphs are not rendered.
+
+#include <Arduino.h>
+
+#include <vector>
+
+#define TFT_BLACK 0x0000
+#define TFT_WHITE 0xFFFF
+
+class TFT_eSPI : public Print
+{
+public:
+  static constexpr int Width  = 240;
+  static constexpr int Height = 320;
+
+  TFT_eSPI();
+
+  void init() {}
+  void setRotation(uint8_t rotation);
+  int16_t width() const { return rotation & 1 ? Height : Width; }
+  int16_t height() const { return rotation & 1 ? Width : Height; }
+
+  void startWrite() {}
+  void endWrite() {}
+  bool initDMA(bool ctrlCs = false) { return true; }
+  void dmaWait() {}
+  bool dmaBusy() { return false; }
+  void setSwapBytes(bool swap) { swapBytes = swap; }
+
+  void fillScreen(uint32_t color);
+  void drawPixel(int32_t x, int32_t y, uint32_t color);
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint16_t *buffer = nullptr) { pushImage(x, y, w, h, data); }
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) const { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextFont(uint8_t) {}
+  void setTextSize(uint8_t size) { textSize = size; }
+  void setTextColor(uint16_t, uint16_t) {}
+  size_t write(uint8_t c) override;
+
+  bool getTouch(uint16_t *x, uint16_t *y, uint16_t threshold = 600) { return false; }
+
+  // host only, colors of the rotated screen, row by row
+  uint16_t getPixel(int32_t x, int32_t y) const;
+  uint32_t getHash() const;
+  bool writePPM(const char *path) const;
+
+  int32_t cursor_x = 0;
+  int32_t cursor_y = 0;
+
+private:
+  uint8_t rotation = 0;
+  bool swapBytes = false;
+  uint8_t textSize = 1;
+  std::vector<uint16_t> framebuffer;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef H_HOST_WIRE
+#define H_HOST_WIRE
+
+// Host stand-in for the ESP32 Wire library, the bus is served by the SimulatedSensor
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire
+{
+public:
+  bool begin() { return true; }
+  void setClock(uint32_t frequency) { clock = frequency; }
+  uint32_t getClock() const { return clock; }
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  uint8_t endTransmission(bool sendStop = true);
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = 1);
+  int available() const { return rxLength - rxIndex; }
+  int read();
+
+private:
+  uint32_t clock = 100000;
+  uint8_t txAddress = 0;
+  uint8_t txBuffer[I2C_BUFFER_LENGTH];
+  size_t txLength = 0;
+  uint16_t registerAddress = 0;
+  uint8_t rxBuffer[I2C_BUFFER_LENGTH];
+  int rxLength = 0;
+  int rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,219 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+HardwareSerial Serial;
+
+namespace {
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+}
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int64_t esp_timer_get_time()
+{
+  return micros();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// half of the 12 bit range, a battery at 3.6 V
+int analogRead(uint8_t pin)
+{
+  return 2048;
+}
+
+size_t Print::print(const char *text)
+{
+  size_t length = 0;
+  while (*text)
+    length += write(*text++);
+  return length;
+}
+
+size_t Print::print(char c)
+{
+  return write(c);
+}
+
+size_t Print::print(int value)
+{
+  return printf("%d", value);
+}
+
+size_t Print::print(unsigned int value)
+{
+  return printf("%u", value);
+}
+
+size_t Print::print(long value)
+{
+  return printf("%ld", value);
+}
+
+size_t Print::print(unsigned long value)
+{
+  return printf("%lu", value);
+}
+
+size_t Print::print(double value, int digits)
+{
+  return printf("%.*f", digits, value);
+}
+
+size_t Print::println(const char *text)
+{
+  return print(text) + print("\r\n");
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return print(buffer);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (c != '\r')
+    fputc(c, stdout);
+  return 1;
+}
+
+int HardwareSerial::available()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return input.size();
+}
+
+int HardwareSerial::read()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (input.empty())
+    return -1;
+  const int c = static_cast<uint8_t>(input[0]);
+  input.erase(0, 1);
+  return c;
+}
+
+// does not wait for more input like the Stream timeout would
+size_t HardwareSerial::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    const int c = read();
+    if (c < 0 || c == terminator)
+      break;
+    buffer[count++] = c;
+  }
+  return count;
+}
+
+void HardwareSerial::receive(const char *text)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  input += text;
+}
+
+// Tasks are detached threads. They are never destroyed, a task may still run while the process exits.
+struct HostTask
+{
+  std::mutex mutex;
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+};
+
+namespace {
+  thread_local HostTask *currentTask = nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+  UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId)
+{
+  HostTask *task = new HostTask();
+  std::thread([=]() {
+    currentTask = task;
+    function(parameters);
+  }).detach();
+
+  if (createdTask != nullptr)
+    *createdTask = task;
+  return pdPASS;
+}
+
+// there is nothing left to run on the host once the loop task removes itself
+void vTaskDelete(TaskHandle_t task)
+{
+  if (task == nullptr || task == currentTask)
+  {
+    fflush(stdout);
+    _Exit(EXIT_FAILURE);
+  }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  delay(ticks);
+}
+
+TickType_t xTaskGetTickCount()
+{
+  return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+  if (currentTask == nullptr)
+    currentTask = new HostTask();
+  return currentTask;
+}
+
+BaseType_t xPortGetCoreID()
+{
+  return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifications++;
+  }
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+  HostTask *task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->mutex);
+
+  auto hasNotifications = [task]() { return task->notifications > 0; };
+  if (ticksToWait == portMAX_DELAY)
+    task->notified.wait(lock, hasNotifications);
+  else
+    task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait), hasNotifications);
+
+  const uint32_t notifications = task->notifications;
+  if (notifications > 0)
+    task->notifications = clearCountOnExit ? 0 : notifications - 1;
+  return notifications;
+}
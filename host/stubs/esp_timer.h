@@ -0,0 +1,8 @@
+#ifndef H_HOST_ESP_TIMER
+#define H_HOST_ESP_TIMER
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
+
+#endif
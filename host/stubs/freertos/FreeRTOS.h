@@ -0,0 +1,20 @@
+#ifndef H_HOST_FREERTOS
+#define H_HOST_FREERTOS
+
+// Host stand-in for the FreeRTOS API the sketch uses: tasks are threads, a tick is a millisecond
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef struct HostTask* TaskHandle_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define portMAX_DELAY 0xFFFFFFFF
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef H_HOST_FREERTOS_TASK
+#define H_HOST_FREERTOS_TASK
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+  UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xPortGetCoreID();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+
+#endif
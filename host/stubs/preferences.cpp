@@ -0,0 +1,89 @@
+#include <Preferences.h>
+
+#include <map>
+#include <vector>
+
+namespace {
+  typedef std::map<std::string, std::vector<uint8_t>> Entries;
+
+  // never destroyed, like the flash it stands in for
+  std::map<std::string, Entries>& getStore() {
+    static std::map<std::string, Entries> *store = new std::map<std::string, Entries>();
+    return *store;
+  }
+
+  std::mutex storeMutex;
+}
+
+bool Preferences::begin(const char *_name, bool _readOnly)
+{
+  if (started || _name == nullptr)
+    return false;
+
+  name = _name;
+  readOnly = _readOnly;
+  started = true;
+  return true;
+}
+
+void Preferences::end()
+{
+  started = false;
+}
+
+bool Preferences::clear()
+{
+  if (!started || readOnly)
+    return false;
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  getStore()[name].clear();
+  return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+  if (!started || readOnly)
+    return false;
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  return getStore()[name].erase(key) > 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t length)
+{
+  if (!started || readOnly || key == nullptr)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  const uint8_t *bytes = static_cast<const uint8_t*>(value);
+  getStore()[name][key].assign(bytes, bytes + length);
+  return length;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  if (!started || key == nullptr)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  const Entries& entries = getStore()[name];
+  const auto entry = entries.find(key);
+  return entry == entries.end() ? 0 : entry->second.size();
+}
+
+// like on the ESP32 nothing is read if the buffer is too small for the entry
+size_t Preferences::getBytes(const char *key, void *buffer, size_t maxLength)
+{
+  if (!started || key == nullptr)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  const Entries& entries = getStore()[name];
+  const auto entry = entries.find(key);
+  if (entry == entries.end() || entry->second.size() > maxLength)
+    return 0;
+
+  memcpy(buffer, entry->second.data(), entry->second.size());
+  return entry->second.size();
+}
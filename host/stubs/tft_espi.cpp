@@ -0,0 +1,120 @@
+#include <TFT_eSPI.h>
+
+TFT_eSPI::TFT_eSPI()
+ : framebuffer(Width * Height, TFT_BLACK)
+{
+}
+
+void TFT_eSPI::setRotation(uint8_t _rotation)
+{
+  rotation = _rotation & 3;
+}
+
+void TFT_eSPI::fillScreen(uint32_t color)
+{
+  std::fill(framebuffer.begin(), framebuffer.end(), color);
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (x < 0 || y < 0 || x >= width() || y >= height())
+    return;
+  framebuffer[y * width() + x] = color;
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  for (int32_t j = y; j < y + h; j++)
+    for (int32_t i = x; i < x + w; i++)
+      drawPixel(i, j, color);
+}
+
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+  auto edge = [](int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t px, int32_t py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+  };
+
+  const int32_t area = edge(x0, y0, x1, y1, x2, y2);
+  for (int32_t y = std::min({y0, y1, y2}); y <= std::max({y0, y1, y2}); y++)
+  {
+    for (int32_t x = std::min({x0, x1, x2}); x <= std::max({x0, x1, x2}); x++)
+    {
+      const int32_t w0 = edge(x1, y1, x2, y2, x, y);
+      const int32_t w1 = edge(x2, y2, x0, y0, x, y);
+      const int32_t w2 = edge(x0, y0, x1, y1, x, y);
+      const bool inside = area >= 0 ? (w0 >= 0 && w1 >= 0 && w2 >= 0) : (w0 <= 0 && w1 <= 0 && w2 <= 0);
+      if (inside)
+        drawPixel(x, y, color);
+    }
+  }
+}
+
+// without swapped bytes the data is in display byte order, i.e. big endian
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
+{
+  for (int32_t j = 0; j < h; j++)
+  {
+    for (int32_t i = 0; i < w; i++)
+    {
+      const uint16_t value = *data++;
+      drawPixel(x + i, y + j, swapBytes ? value : uint16_t((value >> 8) | (value << 8)));
+    }
+  }
+}
+
+size_t TFT_eSPI::write(uint8_t c)
+{
+  if (c == '\n')
+  {
+    cursor_x = 0;
+    cursor_y += 8 * textSize;
+  }
+  else if (c != '\r')
+  {
+    cursor_x += 6 * textSize;
+  }
+  return 1;
+}
+
+uint16_t TFT_eSPI::getPixel(int32_t x, int32_t y) const
+{
+  return framebuffer[y * width() + x];
+}
+
+// FNV-1a over the colors
+uint32_t TFT_eSPI::getHash() const
+{
+  uint32_t hash = 2166136261u;
+  for (uint16_t color : framebuffer)
+  {
+    hash = (hash ^ (color & 0xFF)) * 16777619u;
+    hash = (hash ^ (color >> 8)) * 16777619u;
+  }
+  return hash;
+}
+
+bool TFT_eSPI::writePPM(const char *path) const
+{
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr)
+    return false;
+
+  fprintf(file, "P6\n%d %d\n255\n", width(), height());
+  for (uint16_t color : framebuffer)
+  {
+    const uint8_t rgb[3] = { uint8_t((color >> 11) << 3), uint8_t(((color >> 5) & 0x3F) << 2), uint8_t((color & 0x1F) << 3) };
+    fwrite(rgb, 1, sizeof(rgb), file);
+  }
+  return fclose(file) == 0;
+}
@@ -0,0 +1,75 @@
+#include <Wire.h>
+
+#include "../simulatedsensor.h"
+
+#include <chrono>
+#include <thread>
+
+TwoWire Wire;
+
+// the bus is not faster than the clock, every byte takes 9 bits plus start, address and stop
+static void transferDelay(size_t bytes, uint32_t clock)
+{
+  const uint64_t bits = (bytes + 2) * 9;
+  std::this_thread::sleep_for(std::chrono::microseconds(bits * 1000000 / clock));
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  txAddress = address;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (txLength >= sizeof(txBuffer))
+    return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+// 2 bytes set the register pointer, 4 bytes write a register, 0 bytes probe the address
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  transferDelay(txLength, clock);
+
+  SimulatedSensor& sensor = SimulatedSensor::instance();
+  if (txAddress != SimulatedSensor::Address || !sensor.isConnected())
+    return 2;
+
+  if (txLength >= 2)
+    registerAddress = (txBuffer[0] << 8) | txBuffer[1];
+
+  if (txLength == 4 && !sensor.write(registerAddress, (txBuffer[2] << 8) | txBuffer[3]))
+    return 3;
+
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
+{
+  rxLength = 0;
+  rxIndex = 0;
+  if (quantity > sizeof(rxBuffer))
+    quantity = sizeof(rxBuffer);
+  transferDelay(quantity, clock);
+
+  uint16_t words[I2C_BUFFER_LENGTH / 2];
+  const size_t numWords = quantity / 2;
+  if (address != SimulatedSensor::Address || !SimulatedSensor::instance().read(registerAddress, words, numWords, clock))
+    return 0;
+
+  // big endian as on the bus, the register pointer advances with the read
+  for (size_t i = 0; i < numWords; i++)
+  {
+    rxBuffer[rxLength++] = words[i] >> 8;
+    rxBuffer[rxLength++] = words[i] & 0xFF;
+  }
+  registerAddress += numWords;
+  return rxLength;
+}
+
+int TwoWire::read()
+{
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
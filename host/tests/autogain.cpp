@@ -0,0 +1,60 @@
+// Dynamic range from the image histogram, over the whole temperature range of the sensor
+
+#include "check.h"
+
+#include "autogain.h"
+
+#include <stdlib.h>
+
+namespace {
+  const int NumPixels = 768;
+  const float Tolerance = 0.5f; // two histogram bins
+
+  float randomFloat(float low, float high) {
+    return low + (high - low) * rand() / RAND_MAX;
+  }
+
+  // uniform scene between low and high with the given number of pixels at hotTemp
+  FrameStats makeStats(float low, float high, int hotPixels = 0, float hotTemp = 0.f) {
+    FrameStats stats;
+    stats.clear();
+    for (int i = 0; i < NumPixels; i++)
+      stats.add(toTemperature(i < hotPixels ? hotTemp : randomFloat(low, high)));
+    return stats;
+  }
+}
+
+int main()
+{
+  srand(1);
+
+  // a scene above the former 216 degree end of the histogram
+  AutoGain autoGain;
+  CHECK(autoGain.update(makeStats(250.f, 280.f)));
+  CHECK_NEAR(autoGain.getMinTemp(), 250.f, Tolerance);
+  CHECK_NEAR(autoGain.getMaxTemp(), 280.f, Tolerance);
+
+  // the ends of the sensor range
+  autoGain.invalidate();
+  CHECK(autoGain.update(makeStats(-40.f, -10.f)));
+  CHECK_NEAR(autoGain.getMinTemp(), -40.f, Tolerance);
+  CHECK_NEAR(autoGain.getMaxTemp(), -10.f, Tolerance);
+
+  autoGain.invalidate();
+  CHECK(autoGain.update(makeStats(270.f, 299.f)));
+  CHECK_NEAR(autoGain.getMinTemp(), 270.f, Tolerance);
+  CHECK_NEAR(autoGain.getMaxTemp(), 299.f, Tolerance);
+
+  // less than 1 % of hot pixels do not stretch the range
+  autoGain.invalidate();
+  CHECK(autoGain.update(makeStats(20.f, 30.f, 5, 290.f)));
+  CHECK_NEAR(autoGain.getMinTemp(), 20.f, Tolerance);
+  CHECK_NEAR(autoGain.getMaxTemp(), 30.f, Tolerance);
+
+  // the range moves only once it is off by more than the hysteresis
+  CHECK(!autoGain.update(makeStats(20.5f, 30.5f, 5, 290.f)));
+  CHECK(autoGain.update(makeStats(22.f, 32.f, 5, 290.f)));
+  CHECK_NEAR(autoGain.getMaxTemp(), 32.f, Tolerance);
+
+  return checkResult();
+}
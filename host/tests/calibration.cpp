@@ -0,0 +1,83 @@
+// Accuracy of MLX90640_CalculateToCalibrated against the double precision MLX90640_CalculateTo
+// reference, over random EEPROMs, pixel values, ambient temperatures and both modes
+
+#include "check.h"
+#include "recording.h"
+
+#include "MLX90640_API.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+namespace {
+  const int NumEeproms = 8;
+  const float Emissivity = 0.95f;
+  const float MaxDeviation = 0.01f;
+
+  int randomInt(int low, int high) {
+    return low + rand() % (high - low + 1);
+  }
+
+  // offset, alpha and kta of every pixel at random, without broken or outlier pixels
+  void randomizePixels(uint16_t *eeprom) {
+    for (int p = 0; p < 768; p++)
+      eeprom[64 + p] = (randomInt(1, 0x7FFF) << 1);
+  }
+}
+
+int main()
+{
+  Recording recording;
+  if (!CHECK(recording.load(HOST_DATA_DIR "/scene.rec")))
+    return checkResult();
+
+  static paramsMLX90640 params;
+  static calibrationMLX90640 calibration;
+  float reference[768];
+  float calibrated[768];
+  float deviation = 0.f;
+  int comparedPixels = 0;
+
+  srand(1);
+  for (int i = 0; i < NumEeproms; i++)
+  {
+    Recording::Frame::value_type eeprom[Recording::EepromWords];
+    std::copy(recording.eeprom.begin(), recording.eeprom.end(), eeprom);
+    randomizePixels(eeprom);
+    if (!CHECK(MLX90640_ExtractParameters(eeprom, &params) == 0))
+      continue;
+
+    for (const Recording::Frame& recorded : recording.frames)
+    {
+      Recording::Frame frame = recorded;
+      for (int p = 0; p < 768; p++)
+        frame[p] += randomInt(-2000, 2000);
+      frame[800] += randomInt(-30, 30); // PTAT, moves Ta by a few degrees
+      if (rand() % 2)
+        frame[832] &= ~0x1000; // interleaved mode, which was not calibrated
+
+      const float ta = MLX90640_GetTa(frame.data(), &params);
+      std::fill(reference, reference + 768, 0.f);
+      std::fill(calibrated, calibrated + 768, 0.f);
+      MLX90640_CalculateTo(frame.data(), &params, Emissivity, ta - 8.f, reference);
+      // rebuilt for every frame, a calibration reused within the Ta drift limit is less accurate
+      calibration.valid = 0;
+      MLX90640_UpdateCalibration(frame.data(), &params, &calibration);
+      MLX90640_CalculateToCalibrated(frame.data(), &params, &calibration, Emissivity, ta - 8.f, calibrated);
+
+      for (int p = 0; p < 768; p++)
+      {
+        if (isnan(reference[p]))
+          continue;
+        deviation = std::max(deviation, fabsf(calibrated[p] - reference[p]));
+        comparedPixels++;
+      }
+    }
+  }
+
+  printf("max deviation %.5f over %d pixels\n", deviation, comparedPixels);
+  CHECK(comparedPixels > NumEeproms * int(recording.frames.size()) * 300);
+  CHECK_NEAR(deviation, 0.f, MaxDeviation);
+
+  return checkResult();
+}
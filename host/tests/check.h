@@ -0,0 +1,42 @@
+#ifndef H_CHECK
+#define H_CHECK
+
+// Minimal assertions for the host tests, a failed check is reported and makes checkResult() fail
+
+#include <math.h>
+#include <stdio.h>
+
+namespace check {
+  inline int& failures() {
+    static int count = 0;
+    return count;
+  }
+
+  inline bool report(bool passed, const char *file, int line, const char *expression) {
+    if (!passed)
+    {
+      fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+      failures()++;
+    }
+    return passed;
+  }
+}
+
+#define CHECK(condition) check::report((condition), __FILE__, __LINE__, #condition)
+
+// |actual - expected| <= tolerance, prints both values on failure
+#define CHECK_NEAR(actual, expected, tolerance) \
+  do { \
+    const double checkActual = (actual); \
+    const double checkExpected = (expected); \
+    if (!check::report(fabs(checkActual - checkExpected) <= (tolerance), __FILE__, __LINE__, #actual " near " #expected)) \
+      fprintf(stderr, "  %g vs %g, tolerance %g\n", checkActual, checkExpected, double(tolerance)); \
+  } while (false)
+
+inline int checkResult() {
+  if (check::failures() == 0)
+    printf("passed\n");
+  return check::failures() == 0 ? 0 : 1;
+}
+
+#endif
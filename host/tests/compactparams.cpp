@@ -0,0 +1,95 @@
+// Object temperatures with the compact parameter layout against the float layout. The layouts
+// cannot be linked into one program, so the float build writes its results to a file the compact
+// build compares with.
+//
+//   compactparams <results path>
+
+#include "check.h"
+#include "recording.h"
+
+#include "MLX90640_API.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+  const int NumEeproms = 8;
+  const float Emissivity = 0.95f;
+  const float MaxDeviation = 0.01f;
+
+  int randomInt(int low, int high) {
+    return low + rand() % (high - low + 1);
+  }
+
+  // the To of every subpage with random alpha reference and per-pixel calibration words, as computed by the sensor task
+  std::vector<float> calculate(const Recording& recording) {
+    static paramsMLX90640 params;
+    static calibrationMLX90640 calibration;
+    std::vector<float> results;
+
+    srand(1);
+    for (int i = 0; i < NumEeproms; i++)
+    {
+      uint16_t eeprom[Recording::EepromWords];
+      std::copy(recording.eeprom.begin(), recording.eeprom.end(), eeprom);
+      // odd alpha references near the top of the range leave no headroom, the compact layout drops their low bit
+      eeprom[33] = randomInt(0x7800, 0x7FFF) | 1;
+      for (int p = 0; p < 768; p++)
+        eeprom[64 + p] = (randomInt(1, 0x7FFF) << 1) | (p == 300 ? 1 : 0);
+      if (!CHECK(MLX90640_ExtractParameters(eeprom, &params) == 0))
+        return results;
+      calibration.valid = 0;
+
+      for (const Recording::Frame& recorded : recording.frames)
+      {
+        Recording::Frame frame = recorded;
+        float to[768] = {};
+        const float ta = MLX90640_GetTa(frame.data(), &params);
+        MLX90640_UpdateCalibration(frame.data(), &params, &calibration);
+        MLX90640_CalculateToCalibrated(frame.data(), &params, &calibration, Emissivity, ta - 8.f, to);
+        MLX90640_CorrectBadPixelsCalibrated(frame.data(), &calibration, to);
+        results.insert(results.end(), to, to + 768);
+      }
+    }
+    return results;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <results path>\n", argv[0]);
+    return 1;
+  }
+
+  Recording recording;
+  if (!CHECK(recording.load(HOST_DATA_DIR "/scene.rec")))
+    return checkResult();
+
+  const std::vector<float> results = calculate(recording);
+
+#ifdef MLX90640_COMPACT_PARAMS
+  std::vector<float> reference(results.size());
+  FILE *file = fopen(argv[1], "rb");
+  if (!CHECK(file != nullptr))
+    return checkResult();
+  CHECK(fread(reference.data(), sizeof(float), reference.size(), file) == reference.size());
+  fclose(file);
+
+  float deviation = 0.f;
+  for (size_t i = 0; i < results.size(); i++)
+    deviation = std::max(deviation, fabsf(results[i] - reference[i]));
+  printf("max deviation %.5f over %zu pixels\n", deviation, results.size());
+  CHECK_NEAR(deviation, 0.f, MaxDeviation);
+#else
+  FILE *file = fopen(argv[1], "wb");
+  if (!CHECK(file != nullptr))
+    return checkResult();
+  CHECK(fwrite(results.data(), sizeof(float), results.size(), file) == results.size());
+  fclose(file);
+#endif
+
+  return checkResult();
+}
@@ -0,0 +1,67 @@
+// Equalizing the palette runs once per image on the drawing core, it must stay a small fraction of
+// the frame time.
+
+#include "check.h"
+
+#include "palette.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  const int Width = 32;
+  const int Height = 24;
+  const int EqualizationsPerRun = 1000;
+  const int NumRuns = 20;
+  // generous, the host is an order of magnitude faster than the ESP32 and 64 Hz leaves 15 ms per image
+  const double BudgetNanos = 50000.;
+
+  // 21 degree background with a warm blob and a hot spot, like the recorded scene
+  void makeStats(FrameStats& stats) {
+    stats.clear();
+    for (int y = 0; y < Height; y++)
+      for (int x = 0; x < Width; x++)
+      {
+        const float distance2 = (x - 12.f) * (x - 12.f) + (y - 10.f) * (y - 10.f);
+        float temperature = 21.f + 0.1f * y + 12.f * expf(-distance2 / 12.f) + 0.2f * rand() / RAND_MAX;
+        if (x >= 26 && x <= 27 && y >= 4 && y <= 5)
+          temperature = 65.f;
+        stats.add(toTemperature(temperature));
+      }
+  }
+}
+
+int main()
+{
+  srand(1);
+  FrameStats stats;
+  makeStats(stats);
+
+  Palette palette;
+  palette.setRange(18.f, 70.f);
+  palette.setMapping(PaletteMapping::eEqualized);
+
+  double best = 1e30;
+  for (int run = 0; run < NumRuns; run++)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EqualizationsPerRun; i++)
+      palette.equalize(stats);
+    const auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / EqualizationsPerRun);
+  }
+  printf("equalize %.0f ns per image\n", best);
+  CHECK(best < BudgetNanos);
+
+  // the timed calls remapped the table and did not return early
+  Palette linear;
+  linear.setRange(18.f, 70.f);
+  int remapped = 0;
+  for (int i = 0; i < Palette::Size; i++)
+    remapped += palette.getColorAt(i) != linear.getColorAt(i);
+  CHECK(remapped > Palette::Size / 4);
+
+  return checkResult();
+}
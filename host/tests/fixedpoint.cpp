@@ -0,0 +1,108 @@
+// Runs denoising and upscaling of the same noisy frames in float and in fixed point centi-degrees
+// and bounds the deviation of the fixed point pipeline. A hot spot on a cool background makes the
+// cubic kernel overshoot beyond the int16_t range, which has to saturate instead of wrapping around.
+
+#include "check.h"
+
+#include "filters.h"
+#include "interpolation.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+namespace {
+  const int Width  = 32;
+  const int Height = 24;
+  const int Scale  = 3;
+  const int NumFrames = 16;
+  const float SmoothingFactor = 0.4f;
+
+  float randomFloat(float low, float high) {
+    return low + (high - low) * rand() / RAND_MAX;
+  }
+
+  int16_t toCentiDegrees(float celsius) {
+    return int16_t(lroundf(celsius * 100.f));
+  }
+
+  // against the float result clamped to what centi-degrees can hold
+  template<int Size>
+  float maxDeviation(const float *expected, const int16_t *actual) {
+    float deviation = 0.f;
+    for (int i = 0; i < Size; i++)
+    {
+      const float clamped = std::min(std::max(expected[i], INT16_MIN * 0.01f), INT16_MAX * 0.01f);
+      deviation = std::max(deviation, fabsf(actual[i] * 0.01f - clamped));
+    }
+    return deviation;
+  }
+
+  template<InterpolationType Kind>
+  float upscalingDeviation(const float *floatPixels, const int16_t *fixedPixels) {
+    typedef Interpolator<Width, Height, Scale, Kind> UpScaler;
+    static float floatImage[UpScaler::UpScaledWidth * UpScaler::UpScaledHeight];
+    static int16_t fixedImage[UpScaler::UpScaledWidth * UpScaler::UpScaledHeight];
+
+    UpScaler::process(floatPixels, floatImage);
+    UpScaler::process(fixedPixels, fixedImage);
+    return maxDeviation<UpScaler::UpScaledWidth * UpScaler::UpScaledHeight>(floatImage, fixedImage);
+  }
+}
+
+int main()
+{
+  // the full range of the sensor, with neighbors up to 340 degrees apart
+  float scene[Width * Height];
+  srand(1);
+  for (int i = 0; i < Width * Height; i++)
+    scene[i] = randomFloat(-40.f, 300.f);
+
+  float floatPixels[Width * Height];
+  int16_t fixedPixels[Width * Height];
+  for (int i = 0; i < Width * Height; i++)
+  {
+    floatPixels[i] = scene[i];
+    fixedPixels[i] = toCentiDegrees(scene[i]);
+  }
+
+  for (int frame = 0; frame < NumFrames; frame++)
+  {
+    for (int i = 0; i < Width * Height; i++)
+    {
+      const float measurement = scene[i] + randomFloat(-0.5f, 0.5f);
+      floatPixels[i] = filterExponentional(measurement, floatPixels[i], SmoothingFactor);
+      fixedPixels[i] = filterExponentional(toCentiDegrees(measurement), fixedPixels[i], SmoothingFactor);
+    }
+  }
+
+  const float denoisingDeviation = maxDeviation<Width * Height>(floatPixels, fixedPixels);
+  const float linearDeviation = upscalingDeviation<InterpolationType::eLinear>(floatPixels, fixedPixels);
+  const float cubicDeviation = upscalingDeviation<InterpolationType::eCubic>(floatPixels, fixedPixels);
+  printf("max deviation: denoising %.4f, linear %.4f, cubic %.4f\n", denoisingDeviation, linearDeviation, cubicDeviation);
+
+  CHECK_NEAR(denoisingDeviation, 0.f, 0.03f);
+  CHECK_NEAR(linearDeviation, 0.f, 0.03f);
+  CHECK_NEAR(cubicDeviation, 0.f, 0.05f);
+
+  // a 300 degree 2x2 spot on a 20 degree background, the cubic kernel peaks above 327 degrees
+  for (int i = 0; i < Width * Height; i++)
+  {
+    const int x = i % Width;
+    const int y = i / Width;
+    floatPixels[i] = (x == 15 || x == 16) && (y == 11 || y == 12) ? 300.f : 20.f;
+    fixedPixels[i] = toCentiDegrees(floatPixels[i]);
+  }
+
+  const float linearHotSpotDeviation = upscalingDeviation<InterpolationType::eLinear>(floatPixels, fixedPixels);
+  const float cubicHotSpotDeviation = upscalingDeviation<InterpolationType::eCubic>(floatPixels, fixedPixels);
+  printf("hot spot max deviation: linear %.4f, cubic %.4f\n", linearHotSpotDeviation, cubicHotSpotDeviation);
+
+  CHECK_NEAR(linearHotSpotDeviation, 0.f, 0.03f);
+  CHECK_NEAR(cubicHotSpotDeviation, 0.f, 0.05f);
+
+  // out of range measurements saturate as well
+  CHECK(toTemperature(400.f) == INT16_MAX);
+  CHECK(toTemperature(-400.f) == INT16_MIN);
+
+  return checkResult();
+}
@@ -0,0 +1,110 @@
+// Runs a producer and a consumer thread on a FrameRing and checks that every frame arrives
+// complete and in order, and that the frames that did not arrive are accounted as dropped or
+// overwritten
+
+#include "check.h"
+
+#include "framering.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+  const uint32_t NumFrames = 20000;
+
+  struct Result {
+    uint32_t received = 0;
+    uint32_t missing = 0;    // gaps in the received sequence numbers
+    uint32_t torn = 0;       // frames whose content does not match their sequence number
+    uint32_t unordered = 0;
+  };
+
+  // every word of the frame carries the sequence number, a frame read while it is written shows a mix
+  void fill(SensorFrame& frame, uint32_t sequence) {
+    frame.raw.fill(uint16_t(sequence));
+    frame.pixels.fill(float(sequence));
+    frame.subPage = sequence & 1;
+  }
+
+  bool isComplete(const SensorFrame& frame) {
+    for (uint16_t word : frame.raw)
+      if (word != uint16_t(frame.sequence))
+        return false;
+    for (float pixel : frame.pixels)
+      if (pixel != float(frame.sequence))
+        return false;
+    return frame.subPage == (frame.sequence & 1);
+  }
+
+  template<bool Latest>
+  Result run(FrameRing<2>& ring) {
+    std::atomic<bool> done{false};
+    std::thread producer([&]() {
+      for (uint32_t sequence = 0; sequence < NumFrames; sequence++)
+      {
+        // the ring numbers the frames, they are committed in the order they were begun
+        fill(ring.beginWrite(), sequence);
+        ring.endWrite(sequence);
+        std::this_thread::yield();
+      }
+      done.store(true);
+    });
+
+    Result result;
+    int64_t lastSequence = -1;
+    while (true)
+    {
+      const bool finished = done.load();
+      const SensorFrame *frame = Latest ? ring.readLatest() : ring.readNext();
+      if (frame == nullptr)
+      {
+        if (finished)
+          break;
+        std::this_thread::yield();
+        continue;
+      }
+
+      result.received++;
+      result.torn += !isComplete(*frame);
+      result.unordered += int64_t(frame->sequence) <= lastSequence;
+      result.missing += frame->sequence - lastSequence - 1;
+      lastSequence = frame->sequence;
+      ring.release();
+
+      // fall behind now and then, so the producer runs into a full ring
+      if (result.received % 100 == 0)
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    producer.join();
+    result.missing += NumFrames - 1 - lastSequence;
+    return result;
+  }
+}
+
+int main()
+{
+  {
+    static FrameRing<2> ring;
+    const Result result = run<false>(ring);
+    printf("in order: received %u, dropped %u\n", result.received, ring.getDroppedFrames());
+    CHECK(result.torn == 0);
+    CHECK(result.unordered == 0);
+    CHECK(result.received + ring.getDroppedFrames() == NumFrames);
+    CHECK(result.missing == ring.getDroppedFrames());
+    CHECK(ring.getOverwrittenFrames() == 0);
+  }
+
+  {
+    static FrameRing<2> ring;
+    const Result result = run<true>(ring);
+    printf("latest: received %u, dropped %u, overwritten %u\n", result.received, ring.getDroppedFrames(), ring.getOverwrittenFrames());
+    CHECK(result.torn == 0);
+    CHECK(result.unordered == 0);
+    CHECK(result.received + ring.getDroppedFrames() + ring.getOverwrittenFrames() == NumFrames);
+    CHECK(result.missing == ring.getDroppedFrames() + ring.getOverwrittenFrames());
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,75 @@
+// Collecting the histogram in the denoising pass against a separate pass over the filtered image:
+// both have to give the same statistics. The timings are only printed, wall clock time on a shared
+// host is too noisy to gate on, and the host vectorizes the separate filter loop where the ESP32 can not.
+
+#include "check.h"
+
+#include "filters.h"
+#include "framestats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+
+namespace {
+  const int NumPixels = 768;
+  const int FramesPerRun = 200;
+  const int NumRuns = 25;
+  const float SmoothingFactor = 0.4f;
+
+  Temperature measured[FramesPerRun][NumPixels];
+  Temperature filtered[NumPixels];
+  FrameStats stats;
+
+  void fused(const Temperature *frame) {
+    stats.clear();
+    for (int i = 0; i < NumPixels; i++)
+    {
+      filtered[i] = filterExponentional(frame[i], filtered[i], SmoothingFactor);
+      stats.add(filtered[i]);
+    }
+  }
+
+  void separate(const Temperature *frame) {
+    for (int i = 0; i < NumPixels; i++)
+      filtered[i] = filterExponentional(frame[i], filtered[i], SmoothingFactor);
+
+    stats.clear();
+    for (int i = 0; i < NumPixels; i++)
+      stats.add(filtered[i]);
+  }
+
+  // fastest of several runs in nanoseconds per frame, the filter state starts out the same for each
+  double measure(void (*denoise)(const Temperature *)) {
+    double best = 1e30;
+    for (int run = 0; run < NumRuns; run++)
+    {
+      std::fill(filtered, filtered + NumPixels, toTemperature(20.f));
+      const auto start = std::chrono::steady_clock::now();
+      for (int frame = 0; frame < FramesPerRun; frame++)
+        denoise(measured[frame]);
+      const auto end = std::chrono::steady_clock::now();
+      best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / FramesPerRun);
+    }
+    return best;
+  }
+}
+
+int main()
+{
+  srand(1);
+  for (int frame = 0; frame < FramesPerRun; frame++)
+    for (int i = 0; i < NumPixels; i++)
+      measured[frame][i] = toTemperature(15.f + 30.f * rand() / RAND_MAX);
+
+  const double separateNanos = measure(separate);
+  const FrameStats separateStats = stats;
+  const double fusedNanos = measure(fused);
+
+  CHECK(stats.count == NumPixels);
+  CHECK(stats.histogram == separateStats.histogram);
+
+  printf("fused %.0f ns, separate %.0f ns per frame\n", fusedNanos, separateNanos);
+
+  return checkResult();
+}
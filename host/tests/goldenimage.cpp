@@ -0,0 +1,87 @@
+// Replays the recording through the sensor task and the image pipeline and compares hashes of the
+// drawn screen with host/data/golden.txt. On a mismatch the screen is saved as a PPM to look at.
+//
+//   goldenimage <variant>
+
+#include "check.h"
+#include "simulatedsensor.h"
+
+#include "mlxcamera.h"
+
+#include <TFT_eSPI.h>
+
+#include <string>
+
+namespace {
+  const char *const InterpolationNames[] = { "none", "linear", "cubic" };
+  const InterpolationType InterpolationTypes[] = { InterpolationType::eNone, InterpolationType::eLinear, InterpolationType::eCubic };
+
+  bool findGoldenHash(const std::string& key, uint32_t& hash) {
+    FILE *file = fopen(HOST_DATA_DIR "/golden.txt", "r");
+    if (file == nullptr)
+      return false;
+
+    char name[64];
+    unsigned int value = 0;
+    bool found = false;
+    while (!found && fscanf(file, "%63s %x", name, &value) == 2)
+      found = key == name;
+    fclose(file);
+
+    hash = value;
+    return found;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <variant>\n", argv[0]);
+    return 1;
+  }
+
+  SimulatedSensor& sensor = SimulatedSensor::instance();
+  if (!CHECK(sensor.load(HOST_DATA_DIR "/scene.rec")))
+    return checkResult();
+
+  static TFT_eSPI tft;
+  tft.init();
+  tft.setRotation(3);
+  tft.fillScreen(TFT_BLACK);
+
+  // the camera keeps the previous images in its filters and dirty tiles, the screen depends on the
+  // whole sequence, which the lossless replay keeps independent of the thread timing
+  static MLXCamera camera(tft);
+  if (!CHECK(camera.init()))
+    return checkResult();
+  camera.setSubPageUpdates(true);
+  camera.startSensorTask(0);
+
+  while (!sensor.isFinished() || camera.waitForImage(0))
+  {
+    if (camera.waitForImage(100))
+      camera.readImage();
+  }
+
+  for (int i = 0; i < 3; i++)
+  {
+    tft.setCursor(0, 10);
+    camera.drawImage(InterpolationTypes[i]);
+    camera.drawLegend();
+    camera.drawCenterMeasurement();
+
+    const std::string key = std::string(argv[1]) + "_" + InterpolationNames[i];
+    const uint32_t hash = tft.getHash();
+    uint32_t goldenHash = 0;
+    const bool found = findGoldenHash(key, goldenHash);
+    if (!CHECK(found && hash == goldenHash))
+    {
+      const std::string path = key + ".ppm";
+      tft.writePPM(path.c_str());
+      fprintf(stderr, "%s %08X, screen saved as %s\n", key.c_str(), hash, path.c_str());
+    }
+  }
+
+  return checkResult();
+}
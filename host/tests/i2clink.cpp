@@ -0,0 +1,52 @@
+// Clock steps of the I2C link: only transfer errors back off, overwritten subpages ramp up like good ones
+
+#include "check.h"
+
+#include "i2clink.h"
+
+#include <Wire.h>
+
+namespace {
+  const int NoError = 0;
+  const int NotAcknowledged = -1;
+  const int Overwritten = -8;
+
+  // updates the link with a status until the clock changes, returns the number of updates or 0 if it did not change
+  int updateUntilChange(I2CLink& link, int status, int maxUpdates = 10000) {
+    frameStatsMLX90640 frameStats = { 1, uint8_t(status == Overwritten ? 5 : 1) };
+    for (int i = 1; i <= maxUpdates; i++)
+      if (link.update(status, frameStats, 1000))
+        return i;
+    return 0;
+  }
+}
+
+int main()
+{
+  I2CLink link;
+  link.begin(800000);
+  CHECK(link.getClock() == 800000);
+  CHECK(Wire.getClock() == 800000);
+
+  // overwritten subpages do not back off but ramp up
+  CHECK(updateUntilChange(link, Overwritten) == 32);
+  CHECK(link.getClock() == 1000000);
+  CHECK(Wire.getClock() == 1000000);
+  CHECK(updateUntilChange(link, Overwritten, 100) == 0);
+
+  // a transfer error backs off at once and doubles the run before the next attempt
+  CHECK(updateUntilChange(link, NotAcknowledged) == 1);
+  CHECK(link.getClock() == 800000);
+  CHECK(updateUntilChange(link, NoError) == 64);
+  CHECK(link.getClock() == 1000000);
+
+  CHECK(updateUntilChange(link, NotAcknowledged) == 1);
+  CHECK(updateUntilChange(link, NotAcknowledged) == 1);
+  CHECK(updateUntilChange(link, NotAcknowledged) == 1);
+  CHECK(link.getClock() == 400000);
+  CHECK(updateUntilChange(link, NotAcknowledged, 100) == 0);
+  CHECK(link.getStats().backOffs == 4);
+  CHECK(link.getStats().rampUps == 2);
+
+  return checkResult();
+}
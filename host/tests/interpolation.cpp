@@ -0,0 +1,96 @@
+// Compares the separable upscaling kernels with the per-pixel 4x4 and 2x2 gather kernels they replaced,
+// for the scale of the camera and the ones its pixel size does not allow
+
+#include "check.h"
+
+#include "interpolation.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+namespace {
+  const int Width  = 32;
+  const int Height = 24;
+
+  // the previous kernels, sampling the source at x_idx / upScaleFactor with clamped neighbors
+  float getPoint(const float *p, int rows, int cols, int x, int y) {
+    x = interpolation::clamp(x, 0, cols - 1);
+    y = interpolation::clamp(y, 0, rows - 1);
+    return p[y * cols + x];
+  }
+
+  float cubicInterpolate(const float p[], float x) {
+    return p[1] + (0.5 * x * (p[2] - p[0] + x*(2.0*p[0] - 5.0*p[1] + 4.0*p[2] - p[3] + x*(3.0*(p[1] - p[2]) + p[3] - p[0]))));
+  }
+
+  void gatherBicubic(const float *src, int rows, int cols, float *dest, int destRows, int destCols, int upScaleFactor) {
+    const float mu = 1.f / upScaleFactor;
+    for (int yIdx = 0; yIdx < destRows; yIdx++) {
+      for (int xIdx = 0; xIdx < destCols; xIdx++) {
+        const float x = xIdx * mu;
+        const float y = yIdx * mu;
+        float arr[4];
+        for (int dy = -1; dy < 3; dy++) {
+          float p[4];
+          for (int dx = -1; dx < 3; dx++)
+            p[dx + 1] = getPoint(src, rows, cols, int(x) + dx, int(y) + dy);
+          arr[dy + 1] = cubicInterpolate(p, x - int(x));
+        }
+        dest[yIdx * destCols + xIdx] = cubicInterpolate(arr, y - int(y));
+      }
+    }
+  }
+
+  void gatherBilinear(const float *src, int rows, int cols, float *dest, int destRows, int destCols, int upScaleFactor) {
+    const float mu = 1.f / upScaleFactor;
+    for (int yIdx = 0; yIdx < destRows; yIdx++) {
+      for (int xIdx = 0; xIdx < destCols; xIdx++) {
+        const float x = xIdx * mu;
+        const float y = yIdx * mu;
+        const float fx = x - int(x);
+        const float fy = y - int(y);
+        const float xx = getPoint(src, rows, cols, int(x) + 1, int(y)) * fx + getPoint(src, rows, cols, int(x), int(y)) * (1.f - fx);
+        const float xy = getPoint(src, rows, cols, int(x) + 1, int(y) + 1) * fx + getPoint(src, rows, cols, int(x), int(y) + 1) * (1.f - fx);
+        dest[yIdx * destCols + xIdx] = xy * fy + xx * (1.f - fy);
+      }
+    }
+  }
+
+  template<int Scale, InterpolationType Kind>
+  float maxDeviation(const float *src, void (*reference)(const float *, int, int, float *, int, int, int)) {
+    typedef Interpolator<Width, Height, Scale, Kind> UpScaler;
+    static float expected[UpScaler::UpScaledWidth * UpScaler::UpScaledHeight];
+    static float actual[UpScaler::UpScaledWidth * UpScaler::UpScaledHeight];
+
+    reference(src, Height, Width, expected, UpScaler::UpScaledHeight, UpScaler::UpScaledWidth, Scale);
+    UpScaler::process(src, actual);
+
+    float deviation = 0.f;
+    for (int i = 0; i < UpScaler::UpScaledWidth * UpScaler::UpScaledHeight; i++)
+      deviation = std::max(deviation, fabsf(actual[i] - expected[i]));
+    return deviation;
+  }
+}
+
+int main()
+{
+  float src[Width * Height];
+  srand(1);
+  for (int i = 0; i < Width * Height; i++)
+    src[i] = 20.f + 20.f * rand() / RAND_MAX;
+
+  // twice, the second call uses the weight tables built by the first one
+  for (int i = 0; i < 2; i++)
+  {
+    CHECK_NEAR((maxDeviation<2, InterpolationType::eCubic>(src, gatherBicubic)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<3, InterpolationType::eCubic>(src, gatherBicubic)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<4, InterpolationType::eCubic>(src, gatherBicubic)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<6, InterpolationType::eCubic>(src, gatherBicubic)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<2, InterpolationType::eLinear>(src, gatherBilinear)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<3, InterpolationType::eLinear>(src, gatherBilinear)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<4, InterpolationType::eLinear>(src, gatherBilinear)), 0.f, 1e-3f);
+    CHECK_NEAR((maxDeviation<6, InterpolationType::eLinear>(src, gatherBilinear)), 0.f, 1e-3f);
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,63 @@
+// The color table depends only on the palette type and mapping, a range change only rescales
+// the index and must not touch it
+
+#include "check.h"
+
+#include "palette.h"
+
+#include <array>
+#include <stdlib.h>
+
+namespace {
+#ifdef FIXED_POINT_PIPELINE
+  const int IndexTolerance = 1; // temperatures are rounded to centi-degrees
+#else
+  const int IndexTolerance = 0;
+#endif
+
+  std::array<uint16_t, Palette::Size> getColors(const Palette& palette) {
+    std::array<uint16_t, Palette::Size> colors;
+    for (int i = 0; i < Palette::Size; i++)
+      colors[i] = palette.getColorAt(i);
+    return colors;
+  }
+}
+
+int main()
+{
+  Palette palette;
+  const std::array<uint16_t, Palette::Size> colors = getColors(palette);
+
+  srand(1);
+  for (int i = 0; i < 100; i++)
+  {
+    const float minTemp = -40.f + 100.f * rand() / RAND_MAX;
+    const float maxTemp = minTemp + 0.1f + 200.f * rand() / RAND_MAX;
+    const uint32_t version = palette.getVersion();
+    palette.setRange(minTemp, maxTemp);
+    CHECK(palette.getVersion() != version);
+    CHECK(getColors(palette) == colors);
+
+    palette.setRange(minTemp, maxTemp);
+    CHECK(palette.getVersion() == version + 1);
+
+    // the indices cover the range evenly and saturate outside of it
+    CHECK(palette.getIndex(toTemperature(minTemp - 1.f)) == 0);
+    CHECK(palette.getIndex(toTemperature(maxTemp + 1.f)) == Palette::Size - 1);
+    for (int index = 0; index < Palette::Size; index += 15)
+    {
+      const float temp = minTemp + (index + 0.5f) * (maxTemp - minTemp) / Palette::Size;
+      CHECK_NEAR(palette.getIndex(toTemperature(temp)), index, IndexTolerance);
+    }
+  }
+
+  // a new type rebuilds the table
+  const uint32_t version = palette.getVersion();
+  palette.setType(PaletteType::eIron);
+  CHECK(palette.getVersion() != version);
+  CHECK(getColors(palette) != colors);
+  palette.setType(PaletteType::eRainbow);
+  CHECK(getColors(palette) == colors);
+
+  return checkResult();
+}
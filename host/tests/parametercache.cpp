@@ -0,0 +1,89 @@
+// Round trip of the parameters through the flash cache and rejection of entries that do not
+// belong to the sensor, have another format or were corrupted
+
+#include "check.h"
+#include "recording.h"
+
+#include "parametercache.h"
+
+#include <Preferences.h>
+
+#include <vector>
+
+namespace {
+  // the entries as stored by ParameterCache
+  const char *Namespace = "mlx90640";
+  const char *HeaderKey = "header";
+  const char *ParamsKey = "params";
+
+  std::vector<uint8_t> getEntry(const char *key) {
+    Preferences preferences;
+    preferences.begin(Namespace, true);
+    std::vector<uint8_t> entry(preferences.getBytesLength(key));
+    preferences.getBytes(key, entry.data(), entry.size());
+    preferences.end();
+    return entry;
+  }
+
+  void putEntry(const char *key, const std::vector<uint8_t>& entry) {
+    Preferences preferences;
+    preferences.begin(Namespace, false);
+    preferences.putBytes(key, entry.data(), entry.size());
+    preferences.end();
+  }
+}
+
+int main()
+{
+  Recording recording;
+  if (!CHECK(recording.load(HOST_DATA_DIR "/scene.rec")))
+    return checkResult();
+
+  static paramsMLX90640 params;
+  static paramsMLX90640 loaded;
+  if (!CHECK(MLX90640_ExtractParameters(recording.eeprom.data(), &params) == 0))
+    return checkResult();
+
+  const uint16_t sensorId[ParameterCache::SensorIdWords] = { recording.eeprom[7], recording.eeprom[8], recording.eeprom[9] };
+  const uint16_t otherSensorId[ParameterCache::SensorIdWords] = { recording.eeprom[7], recording.eeprom[8], uint16_t(recording.eeprom[9] + 1) };
+
+  ParameterCache cache;
+  CHECK(!cache.load(sensorId, loaded));
+
+  CHECK(cache.store(sensorId, params));
+  CHECK(cache.load(sensorId, loaded));
+  CHECK(memcmp(&loaded, &params, sizeof(params)) == 0);
+  CHECK(!cache.load(otherSensorId, loaded));
+
+  const std::vector<uint8_t> header = getEntry(HeaderKey);
+  const std::vector<uint8_t> stored = getEntry(ParamsKey);
+
+  // a flipped bit anywhere in the parameters
+  for (size_t i = 0; i < stored.size(); i += 97)
+  {
+    std::vector<uint8_t> corrupted = stored;
+    corrupted[i] ^= 0x10;
+    putEntry(ParamsKey, corrupted);
+    CHECK(!cache.load(sensorId, loaded));
+  }
+
+  std::vector<uint8_t> truncated(stored.begin(), stored.end() - 4);
+  putEntry(ParamsKey, truncated);
+  CHECK(!cache.load(sensorId, loaded));
+  putEntry(ParamsKey, stored);
+  CHECK(cache.load(sensorId, loaded));
+
+  // an entry of another format version, the version is the first field of the header
+  std::vector<uint8_t> otherVersion = header;
+  const uint16_t version = ParameterCache::FormatVersion + 1;
+  memcpy(otherVersion.data(), &version, sizeof(version));
+  putEntry(HeaderKey, otherVersion);
+  CHECK(!cache.load(sensorId, loaded));
+
+  // storing again replaces the stale entry
+  CHECK(cache.store(sensorId, params));
+  CHECK(cache.load(sensorId, loaded));
+  CHECK(memcmp(&loaded, &params, sizeof(params)) == 0);
+
+  return checkResult();
+}
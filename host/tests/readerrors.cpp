@@ -0,0 +1,40 @@
+// Disconnects the simulated sensor while the sensor task runs: the task has to back off instead
+// of retrying as fast as the bus fails, and has to resume once the sensor is back
+
+#include "check.h"
+#include "simulatedsensor.h"
+
+#include "mlxcamera.h"
+
+#include <TFT_eSPI.h>
+
+int main()
+{
+  SimulatedSensor& sensor = SimulatedSensor::instance();
+  if (!CHECK(sensor.load(HOST_DATA_DIR "/scene.rec")))
+    return checkResult();
+  sensor.setRepeats(1000);
+
+  static TFT_eSPI tft;
+  static MLXCamera camera(tft);
+  if (!CHECK(camera.init()))
+    return checkResult();
+  camera.setSubPageUpdates(true);
+  camera.startSensorTask(0);
+  CHECK(camera.waitForImage(1000) && camera.readImage());
+
+  sensor.setConnected(false);
+  const uint32_t transfers = sensor.getTransfers();
+  delay(1000);
+  // every failed read costs one transfer, the back off sleeps 1, 2, 4, ... 256 ms between them
+  const uint32_t failedTransfers = sensor.getTransfers() - transfers;
+  printf("%u transfers in 1 s while disconnected\n", failedTransfers);
+  CHECK(failedTransfers >= 4 && failedTransfers <= 16);
+
+  sensor.setConnected(true);
+  while (camera.waitForImage(0))
+    camera.readImage();
+  CHECK(camera.waitForImage(1000) && camera.readImage());
+
+  return checkResult();
+}
@@ -0,0 +1,190 @@
+// Generates the synthetic recording the host build replays: an EEPROM with typical calibration
+// values and per-pixel variation, and subpages of a scene with a warm moving blob and a hot spot.
+// The raw pixel values are solved with the vendor MLX90640_CalculateTo, so the pipeline has to
+// reproduce the scene temperatures.
+//
+//   makerecording <output path>
+
+#include "../recording.h"
+
+#include "MLX90640_API.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace {
+  const int Width  = 32;
+  const int Height = 24;
+  const int NumSubPages = 24;
+  const float Emissivity = 0.95f;
+  const float TaShift = 8.f;
+
+  const int BrokenPixel  = 300;
+  const int OutlierPixel = 500;
+
+  uint32_t randomState = 12345;
+
+  // deterministic on every platform, unlike rand()
+  int randomInt(int low, int high) {
+    randomState = randomState * 1103515245 + 12345;
+    return low + int((randomState >> 16) % uint32_t(high - low + 1));
+  }
+
+  uint16_t nibbles(int n0, int n1, int n2, int n3) {
+    return (n0 & 0xF) | ((n1 & 0xF) << 4) | ((n2 & 0xF) << 8) | ((n3 & 0xF) << 12);
+  }
+
+  void makeEeprom(uint16_t *ee) {
+    for (int i = 0; i < Recording::EepromWords; i++)
+      ee[i] = 0;
+
+    ee[7] = 0x1234; // sensor ID
+    ee[8] = 0x5678;
+    ee[9] = 0x9ABC;
+    ee[10] = 0x0000; // MLX90640, calibrated in chess mode
+    ee[12] = 0x1901; // control register: chess mode, 18 bit, 2 Hz
+
+    ee[16] = 0x4210; // occ scales, alphaPTAT
+    ee[17] = uint16_t(-70); // offset reference
+    for (int i = 18; i < 32; i++)
+      ee[i] = nibbles(randomInt(-3, 3), randomInt(-3, 3), randomInt(-3, 3), randomInt(-3, 3));
+
+    ee[32] = 0x7884; // acc scales
+    ee[33] = 0x406C; // alpha reference
+    for (int i = 34; i < 48; i++)
+      ee[i] = nibbles(randomInt(-3, 3), randomInt(-3, 3), randomInt(-3, 3), randomInt(-3, 3));
+
+    ee[48] = 0x15CC; // gain
+    ee[49] = 0x2FF1; // vPTAT25
+    ee[50] = 0x2552; // KvPTAT, KtPTAT
+    ee[51] = 0x9C78; // kVdd, vdd25
+    ee[52] = 0x7665; // kv
+    ee[53] = 0x2909; // IL chess
+    ee[54] = 0x5254; // kta averages
+    ee[55] = 0x504E;
+    ee[56] = 0x2462; // resolution, kv and kta scales
+    ee[57] = 0x0446; // CP alpha
+    ee[58] = 0xFBB5; // CP offset
+    ee[59] = 0x0646; // CP kv, kta
+    ee[60] = 0xF020; // KsTa, tgc
+    ee[61] = 0x97E6; // KsTo
+    ee[62] = 0x9797;
+    ee[63] = 0x2889; // corner temperatures
+
+    for (int p = 0; p < Width * Height; p++)
+    {
+      const int offset = randomInt(-8, 8);
+      const int alpha = randomInt(-8, 8);
+      const int kta = randomInt(-2, 2);
+      ee[64 + p] = ((offset & 0x3F) << 10) | ((alpha & 0x3F) << 4) | ((kta & 0x07) << 1);
+    }
+    ee[64 + BrokenPixel] = 0x0000;
+    ee[64 + OutlierPixel] |= 0x0001;
+  }
+
+  // 21 degree background with a vertical gradient, a blob of body temperature moving across the
+  // image and a small hot spot
+  float sceneTemperature(int x, int y, int subPage) {
+    const float blobX = 6.f + subPage * 0.8f;
+    const float blobY = 10.f + 3.f * sinf(subPage * 0.3f);
+    const float distance2 = (x - blobX) * (x - blobX) + (y - blobY) * (y - blobY);
+
+    float temperature = 21.f + 0.1f * y;
+    temperature += 12.f * expf(-distance2 / 12.f);
+    if (x >= 26 && x <= 27 && y >= 4 && y <= 5)
+      temperature = 65.f;
+    return temperature + randomInt(-10, 10) * 0.01f;
+  }
+
+  void makeFrame(const paramsMLX90640& params, int subPage, Recording::Frame& frame) {
+    frame[768] = 0x4BF2; // vBE
+    frame[776] = uint16_t(-54); // CP subpage 0
+    frame[778] = 0x1881; // gain
+    frame[800] = 0x06AF; // PTAT
+    frame[808] = uint16_t(-56); // CP subpage 1
+    frame[810] = uint16_t(-13115); // Vdd
+    frame[832] = 0x1000 | (2 << 10); // chess mode, 18 bit
+    frame[833] = subPage & 1;
+
+    float targets[Width * Height];
+    for (int p = 0; p < Width * Height; p++)
+      targets[p] = sceneTemperature(p % Width, p / Width, subPage);
+
+    const float ta = MLX90640_GetTa(frame.data(), &params);
+
+    // To grows with the raw value, bisect all pixels of the subpage at once, the other ones keep
+    // their value from the previous subpage
+    int32_t low[Width * Height];
+    int32_t high[Width * Height];
+    for (int p = 0; p < Width * Height; p++)
+    {
+      const bool inSubPage = (((p / Width) ^ p) & 1) == subPage % 2;
+      low[p] = inSubPage ? -32768 : int16_t(frame[p]);
+      high[p] = inSubPage ? 32767 : int16_t(frame[p]);
+    }
+
+    float to[Width * Height];
+    for (bool done = false; !done; )
+    {
+      done = true;
+      for (int p = 0; p < Width * Height; p++)
+      {
+        frame[p] = uint16_t((low[p] + high[p]) / 2);
+        done = done && high[p] - low[p] <= 1;
+      }
+
+      for (int p = 0; p < Width * Height; p++)
+        to[p] = NAN;
+      MLX90640_CalculateTo(frame.data(), &params, Emissivity, ta - TaShift, to);
+
+      for (int p = 0; p < Width * Height; p++)
+      {
+        if (isnan(to[p]) && low[p] == high[p])
+          continue;
+        if (isnan(to[p]) || to[p] < targets[p])
+          low[p] = int16_t(frame[p]);
+        else
+          high[p] = int16_t(frame[p]);
+      }
+    }
+
+    for (int p = 0; p < Width * Height; p++)
+      frame[p] = uint16_t(high[p]);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <output path>\n", argv[0]);
+    return 1;
+  }
+
+  Recording recording;
+  makeEeprom(recording.eeprom.data());
+
+  static paramsMLX90640 params;
+  if (MLX90640_ExtractParameters(recording.eeprom.data(), &params) != 0)
+  {
+    fprintf(stderr, "invalid EEPROM\n");
+    return 1;
+  }
+
+  Recording::Frame frame;
+  frame.fill(0);
+  for (int subPage = 0; subPage < NumSubPages; subPage++)
+  {
+    makeFrame(params, subPage, frame);
+    recording.frames.push_back(frame);
+  }
+
+  char comment[128];
+  snprintf(comment, sizeof(comment), "synthetic scene, %d subpages, generated by host/tools/makerecording.cpp", NumSubPages);
+  if (!recording.save(argv[1], comment))
+  {
+    fprintf(stderr, "failed to write %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include "i2clink.h"
+
+#include "MLX90640_I2C_Driver.h"
+
+namespace {
+  const uint32_t clockSteps[] = { 400000, 600000, 800000, 1000000 };
+
+  // status register polls, frame reads and the control register, two bytes per word
+  uint32_t getTransferredBytes(const frameStatsMLX90640& frameStats) {
+    return (frameStats.pollCount + frameStats.readCount * (832 + 1) + 1) * 2;
+  }
+}
+
+I2CLink::I2CLink()
+{
+  static_assert(sizeof(clockSteps) / sizeof(clockSteps[0]) == NumSteps, "one clock per step");
+
+  for (int i = 0; i < NumSteps; i++)
+    rampUpSubPages[i] = MinRampUpSubPages;
+}
+
+void I2CLink::begin(uint32_t clockInHz)
+{
+  int initialStep = 0;
+  while (initialStep < NumSteps - 1 && clockSteps[initialStep + 1] <= clockInHz)
+    initialStep++;
+
+  setStep(initialStep);
+}
+
+bool I2CLink::update(int status, const frameStatsMLX90640& frameStats, uint32_t callMicros)
+{
+  stats.bytes += getTransferredBytes(frameStats);
+  stats.busMicros += callMicros;
+
+  // the sensor did not acknowledge or a register write did not stick, a subpage overwritten during
+  // the read (-8) was transferred fine and counts towards the run to the next clock
+  if (status == -1 || status == -2)
+  {
+    goodSubPages = 0;
+    if (step == 0)
+      return false;
+
+    stats.backOffs++;
+    if (rampUpSubPages[step - 1] < MaxRampUpSubPages)
+      rampUpSubPages[step - 1] *= 2;
+    setStep(step - 1);
+    return true;
+  }
+
+  if (step == NumSteps - 1 || ++goodSubPages < rampUpSubPages[step])
+    return false;
+
+  goodSubPages = 0;
+  stats.rampUps++;
+  setStep(step + 1);
+  return true;
+}
+
+uint32_t I2CLink::getClock() const
+{
+  return clockSteps[step];
+}
+
+uint32_t I2CLink::getThroughput() const
+{
+  if (stats.busMicros == 0)
+    return 0;
+  return uint64_t(stats.bytes) * 1000000 / stats.busMicros;
+}
+
+void I2CLink::setStep(int _step)
+{
+  step = _step;
+  MLX90640_I2CFreqSet(clockSteps[step] / 1000);
+}
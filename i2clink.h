@@ -0,0 +1,50 @@
+#ifndef H_I2CLINK
+#define H_I2CLINK
+
+#include "MLX90640_API.h"
+
+#include <stdint.h>
+
+struct I2CLinkStats
+{
+  uint32_t rampUps = 0;
+  uint32_t backOffs = 0;
+  uint32_t bytes = 0;       // transferred by MLX90640_GetFrameData
+  uint32_t busMicros = 0;   // time spent in MLX90640_GetFrameData
+};
+
+// Runs the sensor bus as fast as it stays reliable. The clock is raised by one step after a run of
+// error free subpages and lowered on every failed transfer. Each back off doubles the run required before
+// the next attempt at the faster clock, so a marginal clock is not retried over and over. A subpage
+// overwritten during the read is no transfer error, it rather asks for a faster bus.
+class I2CLink
+{
+public:
+  I2CLink();
+
+  void begin(uint32_t clockInHz);
+
+  // returns true if the clock changed
+  bool update(int status, const frameStatsMLX90640& frameStats, uint32_t callMicros);
+
+  uint32_t getClock() const;
+  uint32_t getThroughput() const; // bytes per second while reading
+
+  const I2CLinkStats& getStats() const { return stats; }
+  void resetStats() { stats = I2CLinkStats(); }
+
+private:
+  void setStep(int step);
+
+  static constexpr int NumSteps = 4;
+  static constexpr uint32_t MinRampUpSubPages = 32;
+  static constexpr uint32_t MaxRampUpSubPages = 4096;
+
+  int step = 0;
+  uint32_t goodSubPages = 0;
+  uint32_t rampUpSubPages[NumSteps]; // error free subpages before moving up from each step
+
+  I2CLinkStats stats;
+};
+
+#endif
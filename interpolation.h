@@ -1,10 +1,152 @@
 #ifndef H_INTERPOLATION
 #define H_INTERPOLATION
 
-void interpolate_image_bilinear(const float *src, uint8_t src_rows, uint8_t src_cols, 
-                                float *dest, uint8_t dest_rows, uint8_t dest_cols, uint8_t upScaleFactor);
+#include "temperature.h"
 
-void interpolate_image_bicubic(const float *src, uint8_t src_rows, uint8_t src_cols, 
-                               float *dest, uint8_t dest_rows, uint8_t dest_cols, uint8_t upScaleFactor);
+#include <stdint.h>
+
+enum class InterpolationType {
+  eNone,
+  eLinear,
+  eCubic
+};
+
+inline InterpolationType& operator++(InterpolationType& type, int)
+{
+    if (type == InterpolationType::eCubic)
+      type = InterpolationType::eNone;
+    else
+      type = static_cast<InterpolationType>(static_cast<int>(type) + 1);
+    return type;
+};
+
+namespace interpolation
+{
+  constexpr float fraction(int phase, int scale) {
+    return float(phase) / float(scale);
+  }
+
+  // Catmull-Rom weight of the given tap (0..3 for p[-1], p[0], p[1], p[2]) for a sample at x between p[0] and p[1]
+  constexpr float cubicWeight(int tap, float x) {
+    return tap == 0 ? 0.5f * (-x + 2.f * x * x - x * x * x)
+         : tap == 1 ? 0.5f * (2.f - 5.f * x * x + 3.f * x * x * x)
+         : tap == 2 ? 0.5f * (x + 4.f * x * x - 3.f * x * x * x)
+         :            0.5f * (-x * x + x * x * x);
+  }
+
+  // linear weight of the given tap (0..1 for p[0], p[1]) for a sample at x between p[0] and p[1]
+  constexpr float linearWeight(int tap, float x) {
+    return tap == 0 ? 1.f - x : x;
+  }
+
+  constexpr int clamp(int x, int lo, int hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+  }
+
+  // Weights of every phase of a Taps tap kernel in the accumulator format of T, built on first use
+  // and shared by all calls of the same instantiation
+  template<typename T, int Scale, int Taps>
+  struct PhaseWeights
+  {
+    typedef typename SampleTraits<T>::Accumulator Weight;
+
+    Weight values[Scale][Taps];
+
+    PhaseWeights() {
+      for (int phase = 0; phase < Scale; phase++)
+        for (int tap = 0; tap < Taps; tap++)
+          values[phase][tap] = SampleTraits<T>::weight(Taps == 2 ? linearWeight(tap, fraction(phase, Scale)) : cubicWeight(tap, fraction(phase, Scale)));
+    }
+
+    static const PhaseWeights& get() {
+      static const PhaseWeights weights;
+      return weights;
+    }
+  };
+}
+
+// Upscales a Width x Height grid by Scale, producing ((Width - 1) * Scale + 1) x ((Height - 1) * Scale + 1) samples.
+// Source samples land on every Scale-th output sample, so the fractional offsets repeat with the phase
+// (index % Scale) and a table of Scale weight sets, built once per instantiation, replaces all per-pixel
+// weight math. Both kernels are separable: every output row first blends its contributing source rows into
+// a row buffer which is then filtered horizontally. Samples are float or fixed point Temperature values, see SampleTraits.
+template<int Width, int Height, int Scale, InterpolationType Kind>
+struct Interpolator;
+
+template<int Width, int Height, int Scale>
+struct Interpolator<Width, Height, Scale, InterpolationType::eLinear>
+{
+  static constexpr int UpScaledWidth  = (Width  - 1) * Scale + 1;
+  static constexpr int UpScaledHeight = (Height - 1) * Scale + 1;
+
+  template<typename T>
+  static void process(const T *src, T *dest) {
+    typedef SampleTraits<T> Traits;
+    const auto& weights = interpolation::PhaseWeights<T, Scale, 2>::get().values;
+    typename Traits::Accumulator row[Width];
+
+    for (int y = 0; y < Height; y++) {
+      const T *row0 = src + y * Width;
+      const T *row1 = src + interpolation::clamp(y + 1, 0, Height - 1) * Width;
+
+      for (int phaseY = 0; phaseY < (y < Height - 1 ? Scale : 1); phaseY++) {
+        const typename Traits::Accumulator *wy = weights[phaseY];
+        for (int x = 0; x < Width; x++)
+          row[x] = Traits::normalize(row0[x] * wy[0] + row1[x] * wy[1]);
+
+        T *out = dest + (y * Scale + phaseY) * UpScaledWidth;
+        for (int x = 0; x < Width - 1; x++) {
+          for (int phaseX = 0; phaseX < Scale; phaseX++) {
+            const typename Traits::Accumulator *wx = weights[phaseX];
+            *out++ = Traits::saturate(Traits::normalize(row[x] * wx[0] + row[x + 1] * wx[1]));
+          }
+        }
+        *out = Traits::saturate(row[Width - 1]);
+      }
+    }
+  }
+};
+
+template<int Width, int Height, int Scale>
+struct Interpolator<Width, Height, Scale, InterpolationType::eCubic>
+{
+  static constexpr int UpScaledWidth  = (Width  - 1) * Scale + 1;
+  static constexpr int UpScaledHeight = (Height - 1) * Scale + 1;
+
+  template<typename T>
+  static void process(const T *src, T *dest) {
+    typedef SampleTraits<T> Traits;
+    const auto& weights = interpolation::PhaseWeights<T, Scale, 4>::get().values;
+
+    // one sample of edge padding before and two after, so the horizontal taps never need clamping
+    typename Traits::Accumulator paddedRow[1 + Width + 2];
+    typename Traits::Accumulator *row = paddedRow + 1;
+
+    for (int y = 0; y < Height; y++) {
+      const T *rows[4];
+      for (int i = 0; i < 4; i++)
+        rows[i] = src + interpolation::clamp(y + i - 1, 0, Height - 1) * Width;
+
+      for (int phaseY = 0; phaseY < (y < Height - 1 ? Scale : 1); phaseY++) {
+        const typename Traits::Accumulator *wy = weights[phaseY];
+        for (int x = 0; x < Width; x++)
+          row[x] = Traits::normalize(rows[0][x] * wy[0] + rows[1][x] * wy[1] + rows[2][x] * wy[2] + rows[3][x] * wy[3]);
+
+        row[-1] = row[0];
+        row[Width] = row[Width + 1] = row[Width - 1];
+
+        T *out = dest + (y * Scale + phaseY) * UpScaledWidth;
+        for (int x = 0; x < Width - 1; x++) {
+          const typename Traits::Accumulator *p = row + x - 1;
+          for (int phaseX = 0; phaseX < Scale; phaseX++) {
+            const typename Traits::Accumulator *wx = weights[phaseX];
+            *out++ = Traits::saturate(Traits::normalize(p[0] * wx[0] + p[1] * wx[1] + p[2] * wx[2] + p[3] * wx[3]));
+          }
+        }
+        *out = Traits::saturate(row[Width - 1]);
+      }
+    }
+  }
+};
 
 #endif
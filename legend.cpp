@@ -0,0 +1,62 @@
+#include "legend.h"
+
+#include <TFT_eSPI.h>
+#include <stdio.h>
+
+Legend::Legend(TFT_eSPI& _tft)
+ : tft(_tft)
+{}
+
+void Legend::update(const Palette& palette)
+{
+  if (drawn && palette.getVersion() == drawnVersion)
+    return;
+
+  drawn = true;
+  drawnVersion = palette.getVersion();
+  minTemp = palette.getMinTemp();
+  maxTemp = palette.getMaxTemp();
+
+  render(palette);
+  tft.pushImage(tft.width() - BarWidth - BarMargin, BarTop, BarWidth, BarHeight, bar.data());
+
+  tft.setTextFont(1);
+  tft.setTextSize(1);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  drawLabel(maxTemp, tft.width() - 25, 20);
+  drawLabel(minTemp, tft.width() - 25, tft.height() - 10);
+}
+
+int32_t Legend::getPosition(float temp) const
+{
+  return BarTop + BarHeight - 1 - int32_t((temp - minTemp) * (BarHeight - 1) / (maxTemp - minTemp));
+}
+
+// samples the palette at the center of every line, maximum on top
+void Legend::render(const Palette& palette)
+{
+  const float lineTemp = (maxTemp - minTemp) / BarHeight;
+  uint16_t *line = bar.data();
+  for (int y = 0; y < BarHeight; y++)
+  {
+    const uint16_t color = palette.getColor(toTemperature(maxTemp - (y + 0.5f) * lineTemp));
+    const uint16_t swappedColor = (color >> 8) | (color << 8); // display expects big endian
+    for (int x = 0; x < BarWidth; x++)
+      *line++ = swappedColor;
+  }
+}
+
+void Legend::drawLabel(float temp, int32_t x, int32_t y)
+{
+  // the decimal is dropped first if the label is too long, shorter ones are padded to overwrite the previous one
+  char label[12];
+  int length = snprintf(label, sizeof(label), "%.1f", temp);
+  if (length > LabelLength)
+    length = snprintf(label, sizeof(label), "%.0f", temp);
+  for (; length < LabelLength; length++)
+    label[length] = ' ';
+  label[LabelLength] = '\0';
+
+  tft.setCursor(x, y);
+  tft.print(label);
+}
@@ -0,0 +1,42 @@
+#ifndef H_LEGEND
+#define H_LEGEND
+
+#include "palette.h"
+
+#include <array>
+#include <stdint.h>
+
+class TFT_eSPI;
+
+// Color bar of the palette with the range labels next to the image. The bar is rendered from
+// the palette table into a buffer and pushed at once, but only after the colors or the range changed.
+class Legend
+{
+public:
+    Legend(TFT_eSPI& tft);
+
+    void update(const Palette& palette);
+
+    // vertical screen position of a temperature on the bar
+    int32_t getPosition(float temp) const;
+
+private:
+    void render(const Palette& palette);
+    void drawLabel(float temp, int32_t x, int32_t y);
+
+    TFT_eSPI& tft;
+
+    static constexpr int BarWidth  = 15;
+    static constexpr int BarHeight = 190; // display height without the label lines
+    static constexpr int BarTop    = 34;
+    static constexpr int BarMargin = 6;   // to the right display edge
+    static constexpr int LabelLength = 4; // characters that fit next to the bar
+
+    alignas(4) std::array<uint16_t, BarWidth * BarHeight> bar;
+    bool drawn = false;
+    uint32_t drawnVersion = 0;
+    float minTemp = 0.f;
+    float maxTemp = 0.f;
+};
+
+#endif
@@ -1,11 +1,12 @@
 #include "mlxcamera.h"
-#include "interpolation.h"
 #include "filters.h"
+#include "profiler.h"
 
 #include "MLX90640_API.h"
 #include "MLX90640_I2C_Driver.h"
 
 paramsMLX90640 mlx90640;
+calibrationMLX90640 mlxCalibration; // only used by the sensor task
 #define TA_SHIFT 8 //Default shift for MLX90640 in open air
 
 #include <TFT_eSPI.h>
@@ -14,15 +15,12 @@ paramsMLX90640 mlx90640;
 
 //#define DEBUG_INTERPOLATION
 
-namespace {
-  float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
-    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
-  }
-}
-
 MLXCamera::MLXCamera(TFT_eSPI& _tft)
  : tft(_tft)
+ , legend(_tft)
 {
+  palette.setRange(minTemp, maxTemp);
+
 #ifdef DEBUG_INTERPOLATION
    for (int i = 0; i < SensorWidth * SensorHeight; i++)
     measuredPixels[i] = ((i + i / SensorWidth) % 2) == 0 ? 20.f : 30.f;
@@ -43,8 +41,51 @@ bool MLXCamera::init()
     
   Serial.println("MLX90640 online!");
     
-  // Get device parameters - We only have to do this once
-  int status;
+  if (!loadParameters())
+    return false;
+
+  MLX90640_SetChessMode(MLX90640_address);
+  int status = MLX90640_SetRefreshRate(MLX90640_address, 0x05); // Set rate to 8Hz effective - Works at 800kHz
+  if (status != 0)
+  {
+    Serial.println("SetRefreshRate failed");
+    return false;
+  }
+  
+  updatePeriod();
+  Serial.printf("Resolution: %d-bit\n", getResolutionInBit());
+  if (isInterleaved())
+    Serial.println("Mode: Interleaved");
+  else
+    Serial.println("Mode: Chess");
+
+  
+  // Once EEPROM has been read at 400kHz we can increase, the link adapts the clock from there
+  link.begin(800000);
+
+  dmaEnabled = tft.initDMA();
+  tft.setSwapBytes(false); // band buffers are already in display byte order
+
+  return true;
+}
+
+// Get device parameters - from flash if they were extracted for this sensor before
+bool MLXCamera::loadParameters()
+{
+  uint16_t sensorId[ParameterCache::SensorIdWords];
+  int status = MLX90640_I2CRead(MLX90640_address, 0x2407, ParameterCache::SensorIdWords, sensorId);
+  if (status != 0)
+  {
+    Serial.println("Failed to read sensor ID");
+    return false;
+  }
+
+  if (parameterCache.load(sensorId, mlx90640))
+  {
+    Serial.println("Parameters loaded from flash");
+    return true;
+  }
+
   uint16_t eeMLX90640[832];
   status = MLX90640_DumpEE(MLX90640_address, eeMLX90640);
   if (status != 0)
@@ -60,26 +101,63 @@ bool MLXCamera::init()
     return false;
   }
 
-  MLX90640_SetChessMode(MLX90640_address);
-  status = MLX90640_SetRefreshRate(MLX90640_address, 0x05); // Set rate to 8Hz effective - Works at 800kHz
-  if (status != 0)
+  if (!parameterCache.store(sensorId, mlx90640))
+    Serial.println("Failed to store parameters in flash");
+
+  return true;
+}
+
+void MLXCamera::setRefreshRate(float rateInHz)
+{
+  // 0.5 Hz * 2^register value
+  const int rate = lroundf(log2f(std::max(rateInHz, 0.5f))) + 1;
+  requestedRefreshRate.store(std::min(rate, 7), std::memory_order_relaxed);
+}
+
+void MLXCamera::setResolution(int resolutionInBit)
+{
+  requestedResolution.store(constrain(resolutionInBit, 16, 19) - 16, std::memory_order_relaxed);
+}
+
+uint32_t MLXCamera::getImagePeriodInMillis() const
+{
+  const uint32_t periodMicros = subPagePeriodMicros.load(std::memory_order_relaxed);
+  const uint32_t imagePeriodMicros = subPageUpdates.load(std::memory_order_relaxed) ? periodMicros : 2 * periodMicros;
+  return std::max<uint32_t>(imagePeriodMicros / 1000, 1);
+}
+
+// Runs in the sensor task, the only one talking to the sensor after init
+void MLXCamera::applySettings()
+{
+  const int refreshRate = requestedRefreshRate.exchange(-1, std::memory_order_relaxed);
+  if (refreshRate >= 0)
   {
-    Serial.println("SetRefreshRate failed");
-    return false;
+    if (MLX90640_SetRefreshRate(MLX90640_address, refreshRate) == 0)
+      updatePeriod();
+    else
+      Serial.println("SetRefreshRate failed");
   }
-  
-  Serial.printf("RefreshRate: %.1f Hz\n", getRefreshRateInHz());
-  Serial.printf("Resolution: %d-bit\n", getResolutionInBit());
-  if (isInterleaved())
-    Serial.println("Mode: Interleaved");
-  else
-    Serial.println("Mode: Chess");
 
-  
-  // Once EEPROM has been read at 400kHz we can increase
-  Wire.setClock(800000);
+  const int resolution = requestedResolution.exchange(-1, std::memory_order_relaxed);
+  if (resolution >= 0)
+  {
+    if (MLX90640_SetResolution(MLX90640_address, resolution) == 0)
+      Serial.printf("Resolution: %d-bit\n", getResolutionInBit());
+    else
+      Serial.println("SetResolution failed");
+  }
+}
 
-  return true;
+void MLXCamera::updatePeriod()
+{
+  const float refreshRate = getRefreshRateInHz();
+  Serial.printf("RefreshRate: %.1f Hz\n", refreshRate);
+  if (refreshRate > 0.f)
+  {
+    const uint32_t periodMicros = 1000000 / refreshRate; // the refresh rate is the subpage rate
+    subPagePeriodMicros.store(periodMicros, std::memory_order_relaxed);
+    scheduler.setPeriod(periodMicros);
+  }
 }
 
 bool MLXCamera::isConnected() const
@@ -131,122 +209,169 @@ void MLXCamera::setFixedTemperatureRange()
   fixedTemperatureRange = true;
   minTemp = DefaultMinTemp;
   maxTemp = DefaultMaxTemp;
+  palette.setRange(minTemp, maxTemp);
 }
 
 void MLXCamera::setDynamicTemperatureRange()
 {
   fixedTemperatureRange = false;
+  autoGain.invalidate();
 }
 
-void MLXCamera::readImage()
+void MLXCamera::setDynamicRangePercentiles(float low, float high)
 {
-#ifndef DEBUG_INTERPOLATION
-  readPixels();
-  setTempScale();
-#endif
+  autoGain.setPercentiles(low, high);
 }
 
-void MLXCamera::readPixels()
+void MLXCamera::setPaletteType(PaletteType type)
+{
+  palette.setType(type);
+}
+
+void MLXCamera::setPaletteMapping(PaletteMapping mapping)
 {
-  for (byte x = 0 ; x < 2 ; x++) //Read both subpages
+  palette.setMapping(mapping);
+}
+
+void MLXCamera::setSubPageUpdates(bool enabled)
+{
+  subPageUpdates.store(enabled, std::memory_order_relaxed);
+}
+
+bool MLXCamera::waitForImage(uint32_t timeoutInMillis)
+{
+  if (frames.readNext() != nullptr)
+    return true;
+
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutInMillis));
+  return frames.readNext() != nullptr;
+}
+
+// Full frames replace all pixels, so only the latest one is taken and older frames are skipped.
+// Single subpage frames each update only half of the pixels and are merged in order.
+bool MLXCamera::readImage()
+{
+#ifdef DEBUG_INTERPOLATION
+  denoiseRawPixels(DenoisingSmoothingFactor);
+  return true;
+#else
+  bool updated = false;
+  if (subPageUpdates.load(std::memory_order_relaxed))
   {
-    uint16_t mlx90640Frame[834];
-    int status = MLX90640_GetFrameData(MLX90640_address, mlx90640Frame);
-    if (status < 0)
+    while (const SensorFrame *frame = frames.readNext())
     {
-      if (status == -8)
-      {
-        // Could not aquire frame data in certain time, I2C frequency may be too low
-        Serial.println("GetFrame Error: could not aquire frame data in time");
-      }
-      else
-      {
-        Serial.printf("GetFrame Error: %d\n", status);
-      }
+      denoiseSubPage(*frame, DenoisingSmoothingFactor);
+      frames.release();
+      updated = true;
     }
+  }
+  else if (const SensorFrame *frame = frames.readLatest())
+  {
+    measuredPixels = frame->pixels;
+    frames.release();
+    denoiseRawPixels(DenoisingSmoothingFactor);
+    updated = true;
+  }
 
-    const long start = millis(); 
-    
-    const float Ta = MLX90640_GetTa(mlx90640Frame, &mlx90640);    
-    const float tr = Ta - TA_SHIFT; //Reflected temperature based on the sensor ambient temperature  
-    
-    MLX90640_CalculateTo(mlx90640Frame, &mlx90640, SensorEmissivity, tr, measuredPixels.data());
-
-    Serial.printf(" Calculate: %d\n", millis() - start);
+  if (updated)
+  {
+    setTempScale();
+    palette.equalize(imageStats);
   }
+  return updated;
+#endif
 }
 
-uint16_t MLXCamera::getFalseColor(float value) const
+// Runs in the sensor task, reads one or both subpages into the next frame slot
+void MLXCamera::readPixels()
 {
-    // Heatmap code borrowed from: http://www.andrewnoske.com/wiki/Code_-_heatmaps_and_color_gradients
-    static float color[][3] = { {0,0,0}, {0,0,255}, {0,255,0}, {255,255,0}, {255,0,0}, {255,0,255} };
-//    static const float color[][3] = { {0,0,20}, {0,0,100}, {80,0,160}, {220,40,180}, {255,200,20}, {255,235,20}, {255,255,255} };
+  applySettings();
 
-    static const int NUM_COLORS = sizeof(color) / sizeof(color[0]);
-    value = (value - minTemp) / (maxTemp-minTemp);
-    
-    if(value <= 0.f)
-    {
-      return tft.color565(color[0][0], color[0][1], color[0][2]);
-    }
-      
-    if(value >= 1.f)
+  SensorFrame& frame = frames.beginWrite();
+  const byte subPages = subPageUpdates.load(std::memory_order_relaxed) ? 1 : 2;
+
+  for (byte x = 0 ; x < subPages ; x++)
+  {
+    scheduler.sleepUntilDue();
+
+    frameStatsMLX90640 frameStats;
+    const uint32_t callStart = micros();
+    int status = MLX90640_GetFrameData(MLX90640_address, frame.raw.data(), &frameStats);
+    const uint32_t callEnd = micros();
+    scheduler.update(callStart, callEnd, status, frameStats);
+    if (link.update(status, frameStats, callEnd - callStart))
+      scheduler.resetTiming();
+
+    if (status < 0)
     {
-      return tft.color565(color[NUM_COLORS-1][0], color[NUM_COLORS-1][1], color[NUM_COLORS-1][2]);
+      reportReadError(status);
+      return; // incomplete data is not committed, the frame slot is reused by the next call
     }
 
-    value *= NUM_COLORS-1;
-    const int idx1 = floor(value);
-    const int idx2 = idx1+1;
-    const float fractBetween = value - float(idx1);
-  
-    const byte ir = ((color[idx2][0] - color[idx1][0]) * fractBetween) + color[idx1][0];
-    const byte ig = ((color[idx2][1] - color[idx1][1]) * fractBetween) + color[idx1][1];
-    const byte ib = ((color[idx2][2] - color[idx1][2]) * fractBetween) + color[idx1][2];
+    frame.subPage = status;
 
-    return tft.color565(ir, ig, ib);
-}
+    ScopedProfile profile(ProfileStage::eCalculate);
 
-uint16_t MLXCamera::getColor(float val) const
-{
-  /*
-    pass in value and figure out R G B
-    several published ways to do this I basically graphed R G B and developed simple linear equations
-    again a 5-6-5 color display will not need accurate temp to R G B color calculation
-    equations based on
-    http://web-tech.ga-usa.com/2012/05/creating-a-custom-hot-to-cold-temperature-color-gradient-for-use-with-rrdtool/index.html
+    const float Ta = MLX90640_GetTa(frame.raw.data(), &mlx90640);    
+    const float tr = Ta - TA_SHIFT; //Reflected temperature based on the sensor ambient temperature  
     
-  */
+    MLX90640_UpdateCalibration(frame.raw.data(), &mlx90640, &mlxCalibration);
+    MLX90640_CalculateToCalibrated(frame.raw.data(), &mlx90640, &mlxCalibration, SensorEmissivity, tr, frame.pixels.data());
+    MLX90640_CorrectBadPixelsCalibrated(frame.raw.data(), &mlxCalibration, frame.pixels.data());
+  }
 
-  byte red   = constrain(255.0 / (c - b) * val - ((b * 255.0) / (c - b)), 0, 255);
-  byte green = 0;
-  byte blue  = 0;
+  frames.endWrite(millis());
+  profiler.endSensorFrame();
+  if (imageTask != nullptr)
+    xTaskNotifyGive(imageTask);
 
-  if ((val > minTemp) & (val < a)) {
-    green = constrain(255.0 / (a - minTemp) * val - (255.0 * minTemp) / (a - minTemp), 0, 255);
-  }
-  else if ((val >= a) & (val <= c)) {
-    green = 255;
-  }
-  else if (val > c) {
-    green = constrain(255.0 / (c - d) * val - (d * 255.0) / (c - d), 0, 255);
-  }
-  else if ((val > d) | (val < a)) {
-    green = 0;
+  if (scheduler.getStats().subPages >= StatsReportSubPages)
+  {
+    const AcquisitionStats& stats = scheduler.getStats();
+    const I2CLinkStats& linkStats = link.getStats();
+    Serial.printf("{\"subpages\":%u,\"polls\":%u,\"retries\":%u,\"errors\":%u,\"timeouts\":%u,\"sleep_us\":%u,\"read_us\":%u,\"dropped\":%u,\"overwritten\":%u,"
+      "\"i2c_hz\":%u,\"i2c_bytes_per_s\":%u,\"ramp_ups\":%u,\"back_offs\":%u}\n",
+      stats.subPages, stats.polls, stats.retries, stats.errors, stats.timeouts, stats.sleepMicros, stats.readMicros,
+      frames.getDroppedFrames(), frames.getOverwrittenFrames(),
+      link.getClock(), link.getThroughput(), linkStats.rampUps, linkStats.backOffs);
+    scheduler.resetStats();
+    link.resetStats();
   }
+}
 
-  if (val <= b) {
-    blue = constrain(255.0 / (a - b) * val - (255.0 * b) / (a - b), 0, 255);
-  }
-  else if ((val > b) & (val <= d)) {
-    blue = 0;
+// Prints the first error and then at most one per ErrorReportIntervalMillis, with the number of errors since the last one
+void MLXCamera::reportReadError(int status)
+{
+  unreportedErrors++;
+  const uint32_t now = millis();
+  if (errorReported && now - errorReportMillis < ErrorReportIntervalMillis)
+    return;
+
+  if (status == -8)
+  {
+    // Could not aquire frame data in certain time, I2C frequency may be too low
+    Serial.printf("GetFrame Error: could not aquire frame data in time (%u errors)\n", unreportedErrors);
   }
-  else if (val > d) {
-    blue = constrain(240.0 / (maxTemp - d) * val - (d * 240.0) / (maxTemp - d), 0, 240);
+  else
+  {
+    Serial.printf("GetFrame Error: %d (%u errors)\n", status, unreportedErrors);
   }
 
-  // use the displays color mapping function to get 5-6-5 color palet (R=5 bits, G=6 bits, B-5 bits)
-  return tft.color565(red, green, blue);
+  errorReported = true;
+  errorReportMillis = now;
+  unreportedErrors = 0;
+}
+
+void MLXCamera::startSensorTask(int core)
+{
+  imageTask = xTaskGetCurrentTaskHandle(); // woken up for every committed frame
+  xTaskCreatePinnedToCore(sensorTask, "sensor", SensorTaskStackSize, this, 1, nullptr, core);
+}
+
+void MLXCamera::sensorTask(void *camera)
+{
+  for (;;)
+    static_cast<MLXCamera*>(camera)->readPixels();
 }
 
 void MLXCamera::setTempScale()
@@ -254,106 +379,186 @@ void MLXCamera::setTempScale()
   if (fixedTemperatureRange)
     return;
 
-  const auto minmax = std::minmax_element(filteredPixels.begin(), filteredPixels.end());
-  minTemp = *minmax.first;
-  maxTemp = *minmax.second;
-  
-  setAbcd();
-}
+  if (!autoGain.update(imageStats))
+    return;
 
-// Function to get the cutoff points in the temp vs RGB graph.
-void MLXCamera::setAbcd()
-{
-  a = minTemp + (maxTemp - minTemp) * 0.2121;
-  b = minTemp + (maxTemp - minTemp) * 0.3182;
-  c = minTemp + (maxTemp - minTemp) * 0.4242;
-  d = minTemp + (maxTemp - minTemp) * 0.8182;
+  minTemp = autoGain.getMinTemp();
+  maxTemp = autoGain.getMaxTemp();
+  palette.setRange(minTemp, maxTemp);
 }
 
-void MLXCamera::drawImage(const float *pixelData, int width, int height, int scale) const
+// Renders one band of scale display lines per image row and pushes the spans of consecutive changed
+// tiles of it, a fully changed row is a single transfer. With DMA the transfer of a span overlaps
+// the color mapping of the next one.
+void MLXCamera::drawImage(const Temperature *pixelData, int width, int height, int scale)
 {
-  const long start = millis();
-    
+  const int32_t x0 = tft.cursor_x;
+  const int32_t y0 = tft.cursor_y + 10;
+  const int numTiles = (width + TileWidth - 1) / TileWidth;
+
+  // the pushed entries do not tell the colors on screen anymore after a gradient or layout change
+  const bool redrawAll = palette.getGradientVersion() != pushedGradientVersion || width != pushedWidth;
+  pushedGradientVersion = palette.getGradientVersion();
+  pushedWidth = width;
+
+  tft.startWrite();
+
+  int buffer = 0;
   for (int y=0; y<height; y++) {
-    for (int x=0; x<width; x++) {
-      tft.fillRect(tft.cursor_x + x*scale, tft.cursor_y + 10 + y*scale, scale, scale, getFalseColor(pixelData[(width-1-x) + (y*width)]));
+    uint8_t entries[UpScaledWidth];
+    bool dirty[MaxTilesPerRow];
+
+    {
+      ScopedProfile profile(ProfileStage::eColorMapping);
+
+      const Temperature *row = pixelData + y * width;
+      for (int x=0; x<width; x++)
+        entries[x] = palette.getGradientIndex(palette.getIndex(row[width-1-x]));
+
+      uint8_t *pushedRow = pushedEntries.data() + y * width;
+      for (int tile=0; tile<numTiles; tile++) {
+        const int begin = tile * TileWidth;
+        const int end = std::min(begin + TileWidth, width);
+
+        bool changed = redrawAll;
+        for (int x=begin; x<end && !changed; x++)
+          changed = abs(entries[x] - pushedRow[x]) > TileEntryThreshold;
+
+        dirty[tile] = changed;
+        if (changed)
+          memcpy(pushedRow + begin, entries + begin, end - begin);
+        else
+          skippedTiles++;
+      }
+      drawnTiles += numTiles;
+    }
+
+    for (int tile=0; tile<numTiles; tile++) {
+      if (!dirty[tile])
+        continue;
+
+      const int begin = tile * TileWidth;
+      while (tile + 1 < numTiles && dirty[tile + 1])
+        tile++;
+      const int end = std::min((tile + 1) * TileWidth, width);
+      const int spanWidth = (end - begin) * scale;
+
+      uint16_t *band = bandBuffers[buffer].data();
+      buffer ^= 1;
+
+      {
+        ScopedProfile profile(ProfileStage::eColorMapping);
+
+        uint16_t *line = band;
+        for (int x=begin; x<end; x++) {
+          const uint16_t color = palette.getGradientColorAt(entries[x]);
+          const uint16_t swappedColor = (color >> 8) | (color << 8); // display expects big endian
+          for (int i=0; i<scale; i++)
+            *line++ = swappedColor;
+        }
+
+        for (int i=1; i<scale; i++)
+          memcpy(band + i * spanWidth, band, spanWidth * sizeof(uint16_t));
+      }
+
+      ScopedProfile profile(ProfileStage::eDraw);
+      if (dmaEnabled)
+        tft.pushImageDMA(x0 + begin * scale, y0 + y*scale, spanWidth, scale, band);
+      else
+        tft.pushImage(x0 + begin * scale, y0 + y*scale, spanWidth, scale, band);
     }
   }
 
-  Serial.printf("Draw: %d\n", millis() - start);
+  if (dmaEnabled)
+    tft.dmaWait();
+  tft.endWrite();
+
+  if (++drawnImages == StatsReportImages)
+  {
+    Serial.printf("{\"images\":%u,\"tiles\":%u,\"skipped_tiles\":%u,\"skipped_fraction\":%.3f}\n",
+      drawnImages, drawnTiles, skippedTiles, float(skippedTiles) / drawnTiles);
+    drawnImages = 0;
+    drawnTiles = 0;
+    skippedTiles = 0;
+  }
 }
 
 void MLXCamera::denoiseRawPixels(const float smoothingFactor)
 {
-  const long start = millis();
+  ScopedProfile profile(ProfileStage::eDenoise);
 
+  imageStats.clear();
   for (int i = 0; i < SensorWidth * SensorHeight; i++)
-      filteredPixels[i] = filterExponentional(measuredPixels[i], filteredPixels[i], smoothingFactor);
+  {
+    filteredPixels[i] = filterExponentional(toTemperature(measuredPixels[i]), filteredPixels[i], smoothingFactor);
+    imageStats.add(filteredPixels[i]);
+  }
+}
+
+// Merges and denoises only the pixels of the frame's subpage, same pattern as MLX90640_CalculateTo,
+// the statistics still cover the whole image
+void MLXCamera::denoiseSubPage(const SensorFrame& frame, const float smoothingFactor)
+{
+  ScopedProfile profile(ProfileStage::eDenoise);
 
-  Serial.printf("Denoising: %d ", millis() - start);
+  const bool chessMode = (frame.raw[832] & 0x1000) != 0;
+  imageStats.clear();
+  for (int y = 0; y < SensorHeight; y++)
+  {
+    for (int x = 0; x < SensorWidth; x++)
+    {
+      // chess mode: every other pixel of each row, interleaved mode: every pixel of every other row
+      const int subPage = chessMode ? (x ^ y) & 1 : y & 1;
+      const int i = y * SensorWidth + x;
+      if (subPage == frame.subPage)
+      {
+        measuredPixels[i] = frame.pixels[i];
+        filteredPixels[i] = filterExponentional(toTemperature(measuredPixels[i]), filteredPixels[i], smoothingFactor);
+      }
+      imageStats.add(filteredPixels[i]);
+    }
+  }
 }
 
 void MLXCamera::interpolateImage(InterpolationType interpolationType)
 {
-  const long start = millis();
+  ScopedProfile profile(ProfileStage::eInterpolate);
 
   if (interpolationType == InterpolationType::eLinear)
-    interpolate_image_bilinear(filteredPixels.data(), SensorHeight, SensorWidth, upscaledPixels.data(), UpScaledHeight, UpScaledWidth, UpScaleFactor);
+    UpScaler<InterpolationType::eLinear>::process(filteredPixels.data(), upscaledPixels.data());
   else
-    interpolate_image_bicubic(filteredPixels.data(), SensorHeight, SensorWidth, upscaledPixels.data(), UpScaledHeight, UpScaledWidth, UpScaleFactor);
-
-  Serial.printf("Interpolation: %d ", millis() - start);
+    UpScaler<InterpolationType::eCubic>::process(filteredPixels.data(), upscaledPixels.data());
 }
 
 void MLXCamera::drawImage(InterpolationType interpolationType)
 {
-  denoiseRawPixels(DenoisingSmoothingFactor);
-
   if (interpolationType == InterpolationType::eNone)
   {
-    drawImage(filteredPixels.data(), SensorWidth, SensorHeight, 9);
+    drawImage(filteredPixels.data(), SensorWidth, SensorHeight, SensorPixelSize);
   }
   else
   {
     interpolateImage(interpolationType);    
-    drawImage(upscaledPixels.data(), UpScaledWidth, UpScaledHeight, 3);
+    drawImage(upscaledPixels.data(), UpScaledWidth, UpScaledHeight, SensorPixelSize / UpScaleFactor);
   }
 }
 
-void MLXCamera::drawLegendGraph() const
+void MLXCamera::drawLegend()
 {
-  const int legendSize = 15;    
-  const float inc = (maxTemp - minTemp) / (tft.height() - 25 - 25);
-  int j = 0;
-  for (float ii = maxTemp; ii >= minTemp; ii -= inc)
-    tft.drawFastHLine(tft.width() - legendSize - 6, tft.cursor_y + 34 + j++, legendSize, getFalseColor(ii));
-}
- 
-void MLXCamera::drawLegendText() const
-{
-  tft.setTextFont(1);
-  tft.setTextSize(1);
-  tft.setTextColor(TFT_WHITE, TFT_BLACK);
-  tft.setCursor(tft.width() - 25, tft.height() - 10);
-  tft.print(String(minTemp).substring(0, 4));
-  tft.setCursor(tft.width() - 25, 20);
-  tft.print(String(maxTemp).substring(0, 4));
+  legend.update(palette);
 }
 
 void MLXCamera::drawCenterMeasurement() const
 {
-  const int32_t centerX = SensorWidth  * 9 / 2;
-  const int32_t centerY = SensorHeight * 9 / 2 + 20 - 1;
+  const int32_t centerX = SensorWidth  * SensorPixelSize / 2;
+  const int32_t centerY = SensorHeight * SensorPixelSize / 2 + 20 - 1;
   const int32_t halfCrossSize = 3; 
   tft.drawFastHLine(centerX - halfCrossSize, centerY, 2 * halfCrossSize + 1, TFT_WHITE);
   tft.drawFastVLine(centerX, centerY - halfCrossSize, 2 * halfCrossSize + 1, TFT_WHITE);
   
-  const float avgCenterTemperature = (filteredPixels[383 - 16] + filteredPixels[383 - 15] + filteredPixels[384 + 15] + filteredPixels[384 + 16]) * 0.25f;
-  const int32_t legendPixelLength = tft.height() - 25 - 25;
-  const int32_t centerOffset = mapf(avgCenterTemperature, minTemp, maxTemp, 0, legendPixelLength);
-  
+  const float avgCenterTemperature = (toCelsius(filteredPixels[383 - 16]) + toCelsius(filteredPixels[383 - 15]) + toCelsius(filteredPixels[384 + 15]) + toCelsius(filteredPixels[384 + 16])) * 0.25f;
   const int32_t positionX = 296; //tft.width() - legendSize - 6
-  const int32_t positionY = tft.height() - 15 - centerOffset;
+  const int32_t positionY = legend.getPosition(avgCenterTemperature);
 
   const int32_t height = 6;
   const int32_t width  = 6;
@@ -1,26 +1,23 @@
 #ifndef H_MLXCAMERA
 #define H_MLXCAMERA
 
+#include "acquisition.h"
+#include "autogain.h"
+#include "framestats.h"
+#include "i2clink.h"
+#include "interpolation.h"
+#include "legend.h"
+#include "palette.h"
+#include "parametercache.h"
+#include "framering.h"
+#include "temperature.h"
+
 #include <Arduino.h>
 #include <array>
+#include <atomic>
 
 class TFT_eSPI;
 
-enum class InterpolationType {
-  eNone,
-  eLinear,
-  eCubic
-};
-
-inline InterpolationType& operator++(InterpolationType& type, int)
-{
-    if (type == InterpolationType::eCubic)
-      type = InterpolationType::eNone;
-    else
-      type = static_cast<InterpolationType>(static_cast<int>(type) + 1);
-    return type;
-};
-
 class MLXCamera
 {
 public:
@@ -29,24 +26,48 @@ public:
     bool init();
     bool isConnected() const;
 
-    void readImage();
+    // acquires frames on the given core, decoupled from readImage and drawing
+    void startSensorTask(int core);
+
+    // blocks the calling task until the sensor task committed a new frame, returns false on timeout
+    bool waitForImage(uint32_t timeoutInMillis);
+    // consumes new frames and denoises the updated pixels, returns false if there was nothing new
+    bool readImage();
+
+    // a frame per subpage, updating only the pixels of that subpage, instead of one per full frame
+    void setSubPageUpdates(bool enabled);
+
+    // applied by the sensor task before its next read, the rate is rounded to a supported one from 0.5 to 64 Hz
+    void setRefreshRate(float rateInHz);
+    void setResolution(int resolutionInBit);
+    // time between two images from readImage at the current refresh rate
+    uint32_t getImagePeriodInMillis() const;
     
     void drawImage(InterpolationType);
-    void drawLegendGraph() const;
-    void drawLegendText() const;
+    // redraws the legend only if the palette or the range changed
+    void drawLegend();
     void drawCenterMeasurement() const;
 
     void setFixedTemperatureRange();
     void setDynamicTemperatureRange();
+    // fractions of the pixels below and above the dynamic range, which keeps outliers from stretching it
+    void setDynamicRangePercentiles(float low, float high);
+
+    void setPaletteType(PaletteType type);
+    // an equalized mapping is recomputed from the histogram of every image
+    void setPaletteMapping(PaletteMapping mapping);
 
 private:
+    bool loadParameters();
+    void applySettings();
+    void updatePeriod();
+    static void sensorTask(void *camera);
     void readPixels();
+    void reportReadError(int status);
     void setTempScale();
-    void setAbcd();
-    uint16_t getColor(float val) const;
-    uint16_t getFalseColor(float val) const;
-    void drawImage(const float *pixelData, int width, int height, int scale) const;
+    void drawImage(const Temperature *pixelData, int width, int height, int scale);
     void denoiseRawPixels(const float smoothingFactor);
+    void denoiseSubPage(const SensorFrame& frame, const float smoothingFactor);
     void interpolateImage(InterpolationType interpolationType);
 
     float getRefreshRateInHz() const;
@@ -58,29 +79,74 @@ private:
 
     static constexpr int SensorWidth  = 32;
     static constexpr int SensorHeight = 24;
+    static constexpr int SensorTaskStackSize = 4096;
+    static constexpr uint32_t StatsReportSubPages = 256;
+    static constexpr uint32_t ErrorReportIntervalMillis = 1000;
+    AcquisitionScheduler scheduler;
+    std::atomic<uint32_t> subPagePeriodMicros{0};
+    std::atomic<int> requestedRefreshRate{-1}; // register values, -1 if there is no request
+    std::atomic<int> requestedResolution{-1};
+    I2CLink link;
+    bool errorReported = false;
+    uint32_t errorReportMillis = 0;
+    uint32_t unreportedErrors = 0;
+    ParameterCache parameterCache;
+
+    // hands frames from the sensor task to readImage
+    FrameRing<2> frames;
+    TaskHandle_t imageTask = nullptr;
+    std::atomic<bool> subPageUpdates{false};
+
     std::array<float, SensorWidth * SensorHeight> measuredPixels;
-    std::array<float, SensorWidth * SensorHeight> filteredPixels;
+    std::array<Temperature, SensorWidth * SensorHeight> filteredPixels;
+    FrameStats imageStats; // of filteredPixels
 
-    static constexpr int UpScaleFactor  = 3;
-    static constexpr int UpScaledWidth  = (SensorWidth  - 1) * UpScaleFactor + 1;
-    static constexpr int UpScaledHeight = (SensorHeight - 1) * UpScaleFactor + 1;
-    std::array<float, UpScaledWidth * UpScaledHeight> upscaledPixels;
+    // size of a sensor pixel on screen, the upscaled image has to fit into the same area
+    static constexpr int SensorPixelSize = 9;
+    static constexpr int UpScaleFactor   = 3;
+    static_assert(SensorPixelSize % UpScaleFactor == 0, "UpScaleFactor has to divide SensorPixelSize");
+
+    template<InterpolationType Kind>
+    using UpScaler = Interpolator<SensorWidth, SensorHeight, UpScaleFactor, Kind>;
+
+    static constexpr int UpScaledWidth  = UpScaler<InterpolationType::eLinear>::UpScaledWidth;
+    static constexpr int UpScaledHeight = UpScaler<InterpolationType::eLinear>::UpScaledHeight;
+    std::array<Temperature, UpScaledWidth * UpScaledHeight> upscaledPixels;
 
     static constexpr float DefaultMinTemp = 20.f;
     static constexpr float DefaultMaxTemp = 45.f;
     float minTemp = DefaultMinTemp;
     float maxTemp = DefaultMaxTemp;
     bool fixedTemperatureRange = true;
+    AutoGain autoGain;
+
+    Palette palette;
+    Legend legend;
+
+    // two buffers of one band of display lines, one is filled while the other one is transferred
+    static constexpr int MaxBandPixels = SensorWidth * SensorPixelSize * SensorPixelSize;
+    static_assert(UpScaledWidth * SensorPixelSize / UpScaleFactor * SensorPixelSize / UpScaleFactor <= MaxBandPixels, "band buffer too small");
+    alignas(4) std::array<uint16_t, MaxBandPixels> bandBuffers[2];
+    bool dmaEnabled = false;
+
+    // a tile is TileWidth pixels of one image row, it is pushed again only if a gradient entry of it
+    // moved by more than TileEntryThreshold since it was pushed last. Entries, unlike palette indices,
+    // keep their color across range changes and equalization.
+    static constexpr int TileWidth = 8;
+    static constexpr int TileEntryThreshold = 1;
+    static constexpr int MaxTilesPerRow = (UpScaledWidth + TileWidth - 1) / TileWidth;
+    static constexpr uint32_t StatsReportImages = 64;
+    static_assert(SensorWidth <= UpScaledWidth && SensorHeight <= UpScaledHeight, "pushed entries too small");
+    std::array<uint8_t, UpScaledWidth * UpScaledHeight> pushedEntries; // in display order
+    uint32_t pushedGradientVersion = 0;
+    int pushedWidth = 0; // 0 if nothing was pushed yet
+    uint32_t drawnImages = 0;
+    uint32_t drawnTiles = 0;
+    uint32_t skippedTiles = 0;
 
     static constexpr float DenoisingSmoothingFactor = 0.4f;
     static constexpr float SensorEmissivity = 0.95f;
 
-    // cutoff points for temp to RGB conversion
-    float a = 0.0;
-    float b = 0.0;
-    float c = 0.0;
-    float d = 0.0;
-    
     //Default 7-bit unshifted address of the MLX90640
     static const byte MLX90640_address = 0x33;
 };
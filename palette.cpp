@@ -0,0 +1,223 @@
+#include "palette.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace {
+  struct Gradient {
+    const uint8_t (*colors)[3];
+    int numColors;
+  };
+
+  // Heatmap code borrowed from: http://www.andrewnoske.com/wiki/Code_-_heatmaps_and_color_gradients
+  const uint8_t rainbowColors[][3] = { {0,0,0}, {0,0,255}, {0,255,0}, {255,255,0}, {255,0,0}, {255,0,255} };
+  const uint8_t ironColors[][3]    = { {0,0,20}, {0,0,100}, {80,0,160}, {220,40,180}, {255,200,20}, {255,235,20}, {255,255,255} };
+
+  const Gradient rainbow = { rainbowColors, sizeof(rainbowColors) / sizeof(rainbowColors[0]) };
+  const Gradient iron    = { ironColors,    sizeof(ironColors)    / sizeof(ironColors[0]) };
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  uint8_t clampColor(float value, float maxValue = 255.f) {
+    return value <= 0.f ? 0 : (value >= maxValue ? maxValue : value);
+  }
+
+  // value is normalized to [0, 1]
+  uint16_t getGradientColor(const Gradient& gradient, float value) {
+    value *= gradient.numColors - 1;
+    const int idx1 = floor(value);
+    const int idx2 = idx1 + 1 < gradient.numColors ? idx1 + 1 : idx1;
+    const float fractBetween = value - float(idx1);
+
+    const uint8_t *c1 = gradient.colors[idx1];
+    const uint8_t *c2 = gradient.colors[idx2];
+    const uint8_t ir = ((c2[0] - c1[0]) * fractBetween) + c1[0];
+    const uint8_t ig = ((c2[1] - c1[1]) * fractBetween) + c1[1];
+    const uint8_t ib = ((c2[2] - c1[2]) * fractBetween) + c1[2];
+
+    return color565(ir, ig, ib);
+  }
+
+  /*
+    value is normalized to [0, 1]
+    several published ways to do this I basically graphed R G B and developed simple linear equations
+    again a 5-6-5 color display will not need accurate temp to R G B color calculation
+    equations based on
+    http://web-tech.ga-usa.com/2012/05/creating-a-custom-hot-to-cold-temperature-color-gradient-for-use-with-rrdtool/index.html
+    The cutoff points a, b, c and d are relative to the temperature range.
+  */
+  uint16_t getHotColdColor(float val) {
+    const float a = 0.2121f;
+    const float b = 0.3182f;
+    const float c = 0.4242f;
+    const float d = 0.8182f;
+
+    const uint8_t red = clampColor(255.f * (val - b) / (c - b));
+    uint8_t green = 0;
+    uint8_t blue  = 0;
+
+    if ((val > 0.f) && (val < a)) {
+      green = clampColor(255.f * val / a);
+    }
+    else if ((val >= a) && (val <= c)) {
+      green = 255;
+    }
+    else if (val > c) {
+      green = clampColor(255.f * (val - d) / (c - d));
+    }
+
+    if (val <= b) {
+      blue = clampColor(255.f * (val - b) / (a - b));
+    }
+    else if (val > d) {
+      blue = clampColor(240.f * (val - d) / (1.f - d), 240.f);
+    }
+
+    return color565(red, green, blue);
+  }
+}
+
+Palette::Palette()
+{
+  for (int i = 0; i < Size; i++)
+    gradientIndices[i] = i;
+
+  updateScale();
+  rebuild();
+}
+
+void Palette::setType(PaletteType _type)
+{
+  if (type == _type)
+    return;
+
+  type = _type;
+  rebuild();
+}
+
+void Palette::setRange(float _minTemp, float _maxTemp)
+{
+  if (_maxTemp <= _minTemp)
+    _maxTemp = _minTemp + 0.01f;
+
+  if (minTemp == _minTemp && maxTemp == _maxTemp)
+    return;
+
+  minTemp = _minTemp;
+  maxTemp = _maxTemp;
+
+  updateScale();
+  version++;
+}
+
+void Palette::setMapping(PaletteMapping _mapping)
+{
+  if (mapping == _mapping)
+    return;
+
+  mapping = _mapping;
+
+  // an equalized mapping starts out linear until the next image
+  for (int i = 0; i < Size; i++)
+    gradientIndices[i] = i;
+  applyMapping();
+}
+
+void Palette::equalize(const FrameStats& stats)
+{
+  if (mapping != PaletteMapping::eEqualized)
+    return;
+
+  const int firstBin = FrameStats::getBin(toTemperature(minTemp));
+  const int lastBin  = FrameStats::getBin(toTemperature(maxTemp));
+  const int numBins  = lastBin - firstBin + 1;
+
+  uint32_t total = 0;
+  for (int bin = firstBin; bin <= lastBin; bin++)
+    total += stats.histogram[bin];
+  if (total == 0)
+    return;
+
+  // clip the bins and spread the excess evenly over the range, which keeps the total
+  const float clipCount = EqualizationClipLimit * total / numBins;
+  float excess = 0.f;
+  for (int bin = firstBin; bin <= lastBin; bin++)
+    excess += std::max(stats.histogram[bin] - clipCount, 0.f);
+  const float spread = excess / numBins;
+
+  auto getClippedCount = [&](int bin) { return std::min(float(stats.histogram[bin]), clipCount) + spread; };
+
+  // walk the entries and the bins together, the entries sample the cumulative count at the
+  // center of their temperature interval, interpolated linearly within a bin
+  const float entryTemp = (maxTemp - minTemp) / Size;
+  const float indexScale = (Size - 1) / float(total);
+  int bin = firstBin;
+  float binCount = getClippedCount(bin);
+  float cumulative = 0.f; // of the bins below bin
+
+  for (int i = 0; i < Size; i++)
+  {
+    const float temp = minTemp + (i + 0.5f) * entryTemp;
+    const int entryBin = FrameStats::getBin(toTemperature(temp));
+    while (bin < entryBin)
+    {
+      cumulative += binCount;
+      binCount = getClippedCount(++bin);
+    }
+
+    const float fraction = std::min(std::max((temp - FrameStats::getBinTemp(bin)) * FrameStats::BinsPerDegree, 0.f), 1.f);
+    const int index = (cumulative + fraction * binCount) * indexScale + 0.5f;
+    gradientIndices[i] = std::min(index, Size - 1);
+  }
+
+  applyMapping();
+}
+
+void Palette::updateScale()
+{
+#ifdef FIXED_POINT_PIPELINE
+  minValue = toTemperature(minTemp);
+  range = toTemperature(maxTemp) - minValue;
+  if (range < 1)
+    range = 1;
+  scale = (Size << ScaleBits) / range;
+#else
+  minValue = minTemp;
+  scale = Size / (maxTemp - minTemp);
+#endif
+}
+
+void Palette::rebuild()
+{
+  for (int i = 0; i < Size; i++)
+  {
+    // sample every entry at the center of the temperature interval it covers
+    const float value = (i + 0.5f) / Size;
+
+    switch (type)
+    {
+      case PaletteType::eRainbow: gradient[i] = getGradientColor(rainbow, value); break;
+      case PaletteType::eIron:    gradient[i] = getGradientColor(iron, value);    break;
+      case PaletteType::eHotCold: gradient[i] = getHotColdColor(value);           break;
+    }
+  }
+
+  gradientVersion++;
+  applyMapping();
+}
+
+void Palette::applyMapping()
+{
+  bool changed = false;
+  for (int i = 0; i < Size; i++)
+  {
+    const uint16_t color = gradient[gradientIndices[i]];
+    changed |= color != colors[i];
+    colors[i] = color;
+  }
+
+  if (changed)
+    version++;
+}
@@ -0,0 +1,117 @@
+#ifndef H_PALETTE
+#define H_PALETTE
+
+#include "framestats.h"
+#include "temperature.h"
+
+#include <array>
+#include <stdint.h>
+
+enum class PaletteType {
+  eRainbow,
+  eIron,
+  eHotCold
+};
+
+inline PaletteType& operator++(PaletteType& type, int)
+{
+    if (type == PaletteType::eHotCold)
+      type = PaletteType::eRainbow;
+    else
+      type = static_cast<PaletteType>(static_cast<int>(type) + 1);
+    return type;
+};
+
+enum class PaletteMapping {
+  eLinear,   // colors spread evenly over the temperature range
+  eEqualized // colors spread by the histogram of the image, so frequent temperatures get more of them
+};
+
+// RGB565 lookup table of the selected color gradient over the current temperature range.
+// The gradient is rebuilt only when the palette changes, an equalized mapping is baked into
+// the table per image, mapping a temperature to a color stays a scale-and-index.
+class Palette
+{
+public:
+    static constexpr int Size = 256;
+
+    Palette();
+
+    void setType(PaletteType type);
+    PaletteType getType() const { return type; }
+
+    void setRange(float minTemp, float maxTemp);
+    float getMinTemp() const { return minTemp; }
+    float getMaxTemp() const { return maxTemp; }
+
+    void setMapping(PaletteMapping mapping);
+    PaletteMapping getMapping() const { return mapping; }
+    // remaps the gradient by the clipped cumulative histogram of the image over the current range,
+    // does nothing with a linear mapping
+    void equalize(const FrameStats& stats);
+
+    uint8_t getIndex(Temperature value) const
+    {
+#ifdef FIXED_POINT_PIPELINE
+      int32_t delta = int32_t(value) - minValue;
+      if (delta <= 0)
+        return 0;
+      if (delta >= range)
+        return Size - 1;
+      return (delta * scale) >> ScaleBits;
+#else
+      const float index = (value - minValue) * scale;
+      if (index <= 0.f)
+        return 0;
+      if (index >= Size)
+        return Size - 1;
+      return uint8_t(index);
+#endif
+    }
+
+    uint16_t getColor(Temperature value) const { return colors[getIndex(value)]; }
+    uint16_t getColorAt(uint8_t index) const { return colors[index]; }
+
+    // the gradient entry behind a table index, a color stays the same as long as its entry and the
+    // gradient version do, while the equalized mapping moves the entries of the table every image
+    uint8_t getGradientIndex(uint8_t index) const { return gradientIndices[index]; }
+    uint16_t getGradientColorAt(uint8_t gradientIndex) const { return gradient[gradientIndex]; }
+
+    // changes whenever the color of a temperature changes, i.e. the colors or the range
+    uint32_t getVersion() const { return version; }
+    // changes only with the gradient, i.e. the palette type
+    uint32_t getGradientVersion() const { return gradientVersion; }
+
+private:
+    void updateScale();
+    void rebuild();
+    void applyMapping();
+
+    // no temperature bin gets more than this multiple of the mean bin count of the range,
+    // which limits the contrast stretch of large uniform areas like the background
+    static constexpr float EqualizationClipLimit = 4.f;
+
+    PaletteType type = PaletteType::eRainbow;
+    PaletteMapping mapping = PaletteMapping::eLinear;
+    float minTemp = 0.f;
+    float maxTemp = 1.f;
+
+#ifdef FIXED_POINT_PIPELINE
+    // index = (value - minValue) * scale >> ScaleBits, value - minValue is clamped to [0, range)
+    static constexpr int ScaleBits = 16;
+    int32_t minValue = 0;
+    int32_t range = 1;
+    int32_t scale = 0;
+#else
+    float minValue = 0.f;
+    float scale = 0.f;
+#endif
+
+    std::array<uint16_t, Size> gradient;
+    std::array<uint8_t, Size> gradientIndices; // gradient entry of every color, the identity for a linear mapping
+    std::array<uint16_t, Size> colors;
+    uint32_t version = 0;
+    uint32_t gradientVersion = 0;
+};
+
+#endif
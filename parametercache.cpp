@@ -0,0 +1,60 @@
+#include "parametercache.h"
+
+#include <Preferences.h>
+#include <string.h>
+
+namespace {
+  const char* Namespace = "mlx90640";
+  const char* HeaderKey = "header";
+  const char* ParamsKey = "params";
+
+  uint32_t crc32(const void *data, size_t length) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+      crc ^= bytes[i];
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+  }
+}
+
+bool ParameterCache::load(const uint16_t (&sensorId)[SensorIdWords], paramsMLX90640& params) const
+{
+  Preferences preferences;
+  if (!preferences.begin(Namespace, true))
+    return false;
+
+  Header header;
+  const bool loaded = preferences.getBytes(HeaderKey, &header, sizeof(header)) == sizeof(header)
+    && header.version == FormatVersion
+    && header.size == sizeof(params)
+    && memcmp(header.sensorId, sensorId, sizeof(header.sensorId)) == 0
+    && preferences.getBytes(ParamsKey, &params, sizeof(params)) == sizeof(params)
+    && crc32(&params, sizeof(params)) == header.crc;
+
+  preferences.end();
+  return loaded;
+}
+
+bool ParameterCache::store(const uint16_t (&sensorId)[SensorIdWords], const paramsMLX90640& params) const
+{
+  Preferences preferences;
+  if (!preferences.begin(Namespace, false))
+    return false;
+
+  Header header;
+  header.version = FormatVersion;
+  header.size = sizeof(params);
+  memcpy(header.sensorId, sensorId, sizeof(header.sensorId));
+  header.crc = crc32(&params, sizeof(params));
+
+  // parameters first, a stale header never matches them
+  const bool stored = preferences.putBytes(ParamsKey, &params, sizeof(params)) == sizeof(params)
+    && preferences.putBytes(HeaderKey, &header, sizeof(header)) == sizeof(header);
+
+  preferences.end();
+  return stored;
+}
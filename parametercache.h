@@ -0,0 +1,31 @@
+#ifndef H_PARAMETERCACHE
+#define H_PARAMETERCACHE
+
+#include "MLX90640_API.h"
+
+#include <stdint.h>
+
+// Keeps the parameters extracted from the sensor EEPROM in flash (NVS), so later boots can skip
+// dumping and extracting the EEPROM. An entry only matches the sensor with the same ID and format
+// version and is verified by a CRC over the stored parameters.
+class ParameterCache
+{
+public:
+  static constexpr int SensorIdWords = 3;
+  // bump whenever the meaning of the stored parameters changes, e.g. their extraction
+  static constexpr uint16_t FormatVersion = 1;
+
+  bool load(const uint16_t (&sensorId)[SensorIdWords], paramsMLX90640& params) const;
+  bool store(const uint16_t (&sensorId)[SensorIdWords], const paramsMLX90640& params) const;
+
+private:
+  struct Header
+  {
+    uint16_t version;
+    uint16_t sensorId[SensorIdWords];
+    uint32_t size;  // of paramsMLX90640, changes with the layout
+    uint32_t crc;
+  };
+};
+
+#endif
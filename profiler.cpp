@@ -0,0 +1,106 @@
+#include "profiler.h"
+
+#include <algorithm>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <stdio.h>
+#endif
+
+Profiler profiler;
+
+namespace {
+  const char* stageNames[] = { "calculate", "denoise", "interpolate", "colormap", "draw", "frame" };
+
+  uint64_t ticksToNanos(uint32_t ticks) {
+#ifdef ARDUINO
+    return uint64_t(ticks) * 1000 / getCpuFrequencyMhz();
+#else
+    return ticks;
+#endif
+  }
+}
+
+uint32_t Profiler::ticks()
+{
+#ifdef ARDUINO
+  return ESP.getCycleCount();
+#else
+  return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void Profiler::beginFrame()
+{
+  for (int i = 0; i < NumStages; i++)
+    if (!isSensorStage(i))
+      frameTicks[i].store(0, std::memory_order_relaxed);
+  frameStart = ticks();
+}
+
+void Profiler::endFrame()
+{
+  add(ProfileStage::eFrame, ticks() - frameStart);
+
+  for (int i = 0; i < NumStages; i++)
+    if (!isSensorStage(i))
+      samples[i][sampleCount] = frameTicks[i].load(std::memory_order_relaxed);
+
+  if (++sampleCount == SamplesPerReport)
+  {
+    report(false);
+    sampleCount = 0;
+  }
+}
+
+void Profiler::endSensorFrame()
+{
+  for (int i = 0; i < NumStages; i++)
+    if (isSensorStage(i))
+      samples[i][sensorSampleCount] = frameTicks[i].exchange(0, std::memory_order_relaxed);
+
+  if (++sensorSampleCount == SamplesPerReport)
+  {
+    report(true);
+    sensorSampleCount = 0;
+  }
+}
+
+void Profiler::add(ProfileStage stage, uint32_t ticks)
+{
+  frameTicks[static_cast<int>(stage)].fetch_add(ticks, std::memory_order_relaxed);
+}
+
+void Profiler::report(bool sensorStages) const
+{
+  uint32_t sorted[SamplesPerReport];
+
+  for (int i = 0; i < NumStages; i++)
+  {
+    if (isSensorStage(i) != sensorStages)
+      continue;
+
+    std::copy(samples[i], samples[i] + SamplesPerReport, sorted);
+    std::sort(sorted, sorted + SamplesPerReport);
+
+    const uint32_t minTicks    = sorted[0];
+    const uint32_t medianTicks = sorted[SamplesPerReport / 2];
+    const uint32_t p99Ticks    = sorted[(SamplesPerReport * 99 - 1) / 100];
+
+    char line[128];
+    snprintf(line, sizeof(line), "{\"stage\":\"%s\",\"frames\":%d,\"min_ns\":%llu,\"median_ns\":%llu,\"p99_ns\":%llu}",
+      stageNames[i], SamplesPerReport,
+      (unsigned long long)ticksToNanos(minTicks),
+      (unsigned long long)ticksToNanos(medianTicks),
+      (unsigned long long)ticksToNanos(p99Ticks));
+
+#ifdef ARDUINO
+    Serial.println(line);
+#else
+    puts(line);
+#endif
+  }
+}
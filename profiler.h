@@ -0,0 +1,72 @@
+#ifndef H_PROFILER
+#define H_PROFILER
+
+#include <atomic>
+#include <stdint.h>
+
+enum class ProfileStage : uint8_t {
+  eCalculate,
+  eDenoise,
+  eInterpolate,
+  eColorMapping,
+  eDraw,
+  eFrame,
+  eCount
+};
+
+// Collects per-stage timings, summed per frame, and reports min/median/p99
+// in nanoseconds once every SamplesPerReport frames. The calculate stage runs in
+// the sensor task and is sampled per committed sensor frame by endSensorFrame(),
+// the other stages per drawn frame between beginFrame() and endFrame() in loop().
+class Profiler
+{
+public:
+  static constexpr int SamplesPerReport = 64;
+
+  void beginFrame();
+  void endFrame();
+  void endSensorFrame();
+
+  void add(ProfileStage stage, uint32_t ticks);
+
+  static uint32_t ticks();
+
+private:
+  static constexpr int NumStages = static_cast<int>(ProfileStage::eCount);
+
+  static bool isSensorStage(int stage) {
+    return stage == static_cast<int>(ProfileStage::eCalculate);
+  }
+
+  // each task only touches the samples of its own stages
+  void report(bool sensorStages) const;
+
+  uint32_t frameStart = 0;
+  std::atomic<uint32_t> frameTicks[NumStages];
+  uint32_t samples[NumStages][SamplesPerReport] = {};
+  int sampleCount = 0;
+  int sensorSampleCount = 0;
+};
+
+extern Profiler profiler;
+
+class ScopedProfile
+{
+public:
+  ScopedProfile(ProfileStage _stage)
+  : stage(_stage)
+  , start(Profiler::ticks())
+  {
+  }
+
+  ~ScopedProfile()
+  {
+    profiler.add(stage, Profiler::ticks() - start);
+  }
+
+private:
+  ProfileStage stage;
+  uint32_t start;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef H_SPSCQUEUE
+#define H_SPSCQUEUE
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+
+// head and tail are kept on separate cache lines, so producer and consumer do not contend
+static constexpr size_t SpscCacheLineSize = 64;
+
+// Wait-free queue for exactly one producer and one consumer thread with Capacity preallocated slots.
+// The producer fills the slot returned by back() in place and publishes it with push(),
+// the consumer reads the slot returned by front() in place and releases it with pop().
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+  // producer side, returns nullptr if the queue is full
+  T* back()
+  {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == Capacity)
+      return nullptr;
+    return &slots[h & (Capacity - 1)];
+  }
+
+  void push()
+  {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // consumer side, returns nullptr if the queue is empty
+  T* front()
+  {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t)
+      return nullptr;
+    return &slots[t & (Capacity - 1)];
+  }
+
+  void pop()
+  {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  size_t size() const
+  {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<T, Capacity> slots;
+  alignas(SpscCacheLineSize) std::atomic<size_t> head{0};
+  alignas(SpscCacheLineSize) std::atomic<size_t> tail{0};
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef H_TEMPERATURE
+#define H_TEMPERATURE
+
+#include <stdint.h>
+
+// Process the image in fixed point centi-degrees instead of float, which halves the
+// memory of the image buffers and keeps denoising and interpolation on the integer ALU
+//#define FIXED_POINT_PIPELINE
+
+#ifdef FIXED_POINT_PIPELINE
+typedef int16_t Temperature; // in 1/100 degree Celsius
+
+// saturates at +-327 degrees, converting a float out of the int16_t range is undefined
+inline Temperature toTemperature(float celsius) {
+  const float value = celsius * 100.f + (celsius >= 0.f ? 0.5f : -0.5f);
+  if (value >= INT16_MAX)
+    return INT16_MAX;
+  if (value <= INT16_MIN)
+    return INT16_MIN;
+  return Temperature(value);
+}
+
+inline float toCelsius(Temperature temperature) {
+  return temperature * 0.01f;
+}
+#else
+typedef float Temperature;
+
+inline Temperature toTemperature(float celsius) {
+  return celsius;
+}
+
+inline float toCelsius(Temperature temperature) {
+  return temperature;
+}
+#endif
+
+// Arithmetic used by the image kernels: weighted sums are accumulated in Accumulator
+// and brought back to the sample scale by normalize(), saturate() narrows them to a sample.
+template<typename T>
+struct SampleTraits;
+
+template<>
+struct SampleTraits<float>
+{
+  typedef float Accumulator;
+
+  static constexpr float weight(float w) {
+    return w;
+  }
+
+  static float normalize(float value) {
+    return value;
+  }
+
+  static float saturate(float value) {
+    return value;
+  }
+};
+
+template<>
+struct SampleTraits<int16_t>
+{
+  typedef int32_t Accumulator;
+
+  // weights in Q14, a 4-tap sum over +-327 degrees still fits 32 bits
+  static constexpr int WeightBits = 14;
+
+  static constexpr int32_t weight(float w) {
+    return int32_t(w * (1 << WeightBits) + (w >= 0.f ? 0.5f : -0.5f));
+  }
+
+  static int32_t normalize(int32_t value) {
+    return (value + (1 << (WeightBits - 1))) >> WeightBits;
+  }
+
+  // narrows a normalized sum to a sample, cubic overshoot next to a hot spot must not wrap around
+  static int16_t saturate(int32_t value) {
+    return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : int16_t(value));
+  }
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "infobar.h"
 #include "mlxcamera.h"
+#include "profiler.h"
 
 #include <TFT_eSPI.h>
 TFT_eSPI tft = TFT_eSPI();
@@ -7,10 +8,12 @@ TFT_eSPI tft = TFT_eSPI();
 MLXCamera camera(tft);
 InfoBar infoBar = InfoBar(tft);
 const uint32_t InfoBarHeight = 10;
-const uint32_t MaxFrameTimeInMillis = 33;
+const uint32_t MaxTouchLatencyInMillis = 100;
+const int SensorCore = 0; // loop() runs on core 1
 
 InterpolationType interpolationType = InterpolationType::eLinear;
 bool fixedTemperatureRange = true;
+bool subPageUpdates = true; // halves the latency, the image is updated at the subpage rate
 
 void setup() {
     tft.init();
@@ -27,16 +30,49 @@ void setup() {
       vTaskDelete(NULL); // remove loop task
     }
 
-    camera.drawLegendGraph();
+    camera.setSubPageUpdates(subPageUpdates);
+    camera.startSensorTask(SensorCore);
 }
 
-void loop() {
-    const long start = millis();
+// "rate <Hz>" and "resolution <bit>" on the serial console trade noise for speed at runtime,
+// "mapping linear|equalized" selects how the palette colors spread over the range
+void runSerialCommand(const char *line) {
+    float rate = 0.f;
+    int resolution = 0;
+    char mapping[12];
+    if (sscanf(line, "rate %f", &rate) == 1)
+      camera.setRefreshRate(rate);
+    else if (sscanf(line, "resolution %d", &resolution) == 1)
+      camera.setResolution(resolution);
+    else if (sscanf(line, "mapping %11s", mapping) == 1)
+      camera.setPaletteMapping(strcmp(mapping, "equalized") == 0 ? PaletteMapping::eEqualized : PaletteMapping::eLinear);
+}
 
-    camera.readImage();
+// collects the characters that arrived so far without waiting for the rest of the line
+void handleSerialCommand() {
+    static char line[32];
+    static size_t length = 0;
 
-    const long processingTime = millis() - start;
+    while (Serial.available())
+    {
+      const char c = Serial.read();
+      if (c == '\r')
+        continue;
+
+      if (c != '\n')
+      {
+        if (length < sizeof(line) - 1)
+          line[length++] = c; // longer lines are truncated
+        continue;
+      }
+
+      line[length] = '\0';
+      length = 0;
+      runSerialCommand(line);
+    }
+}
 
+void loop() {
     uint16_t dummyX = 0, dummyY = 0;
     if (tft.getTouch(&dummyX, &dummyY))
     {
@@ -51,15 +87,29 @@ void loop() {
           camera.setDynamicTemperatureRange();
       }
     }
-    
+
+    handleSerialCommand();
+
+    // draw at the rate new frames arrive from the sensor task
+    const uint32_t timeout = std::min(camera.getImagePeriodInMillis(), MaxTouchLatencyInMillis);
+    if (!camera.waitForImage(timeout))
+      return;
+
+    const long start = millis();
+    profiler.beginFrame();
+
+    if (!camera.readImage())
+      return;
+
+    const long processingTime = millis() - start;
+
     tft.setCursor(0, InfoBarHeight);
     camera.drawImage(interpolationType);
-    camera.drawLegendText();
+    camera.drawLegend();
     camera.drawCenterMeasurement();
 
+    profiler.endFrame();
     const long frameTime = millis() - start;
 
     infoBar.update(start, processingTime, frameTime);
-    if (frameTime < MaxFrameTimeInMillis)
-    delay(MaxFrameTimeInMillis - frameTime);
 }